@@ -4,6 +4,7 @@
 
 #include "bench.h"
 
+#include "crypto/other/sha256.h"
 #include "key.h"
 #include "stacktraces.h"
 #include "validation.h"
@@ -11,8 +12,11 @@
 
 #include "bls/bls.h"
 
+void InitBLSTests();
 void CleanupBLSTests();
 void CleanupBLSDkgTests();
+void CleanupBLSSigSharesTests();
+void CleanupInstantSendTests();
 
 int
 main(int argc, char** argv)
@@ -20,6 +24,7 @@ main(int argc, char** argv)
     RegisterPrettySignalHandlers();
     RegisterPrettyTerminateHander();
 
+    SHA256AutoDetect();
     ECC_Start();
     ECCVerifyHandle verifyHandle;
 
@@ -27,9 +32,13 @@ main(int argc, char** argv)
     SetupEnvironment();
     fPrintToDebugLog = false; // don't want to write to debug.log file
 
+    InitBLSTests();
+
     benchmark::BenchRunner::RunAll();
 
     // need to be called before global destructors kick in (PoolAllocator is needed due to many BLSSecretKeys)
+    CleanupInstantSendTests();
+    CleanupBLSSigSharesTests();
     CleanupBLSDkgTests();
     CleanupBLSTests();
 
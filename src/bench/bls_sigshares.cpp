@@ -0,0 +1,273 @@
+// Copyright (c) 2020 The BeeGroup developers are EternityGroup
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "random.h"
+#include "bls/bls_batchverifier.h"
+#include "bls/bls_worker.h"
+#include "llmq/quorums_signing.h"
+#include "llmq/quorums_signing_shares.h"
+#include "memusage.h"
+#include "util.h"
+#include "utiltime.h"
+
+#include <iostream>
+
+extern CBLSWorker blsWorker;
+
+// Simulates the verification of incoming sig shares for a single LLMQ, as done by CSigSharesManager
+struct SigSharesQuorum
+{
+    struct SigShare {
+        size_t source;
+        size_t member;
+        uint256 signHash;
+        CBLSSignature sig;
+    };
+
+    // sig shares are received from this many peers
+    static const size_t SOURCE_COUNT = 8;
+    // and this many signing sessions are verified at once
+    static const size_t SESSION_COUNT = 8;
+
+    std::vector<CBLSId> ids;
+    BLSPublicKeyVector pubKeyShares;
+    std::vector<SigShare> sigShares;
+
+    SigSharesQuorum(int quorumSize)
+    {
+        ids.resize(quorumSize);
+        for (int i = 0; i < quorumSize; i++) {
+            ids[i].SetInt(i + 1);
+        }
+
+        BLSVerificationVectorPtr vvec;
+        BLSSecretKeyVector skShares;
+        blsWorker.GenerateContributions(quorumSize / 2 + 1, ids, vvec, skShares);
+
+        pubKeyShares.resize(quorumSize);
+        for (int i = 0; i < quorumSize; i++) {
+            pubKeyShares[i] = blsWorker.BuildPubKeyShare(vvec, ids[i]);
+        }
+
+        for (size_t i = 0; i < SESSION_COUNT; i++) {
+            uint256 signHash = GetRandHash();
+            for (int j = 0; j < quorumSize; j++) {
+                SigShare sigShare;
+                sigShare.source = GetRandInt(SOURCE_COUNT);
+                sigShare.member = j;
+                sigShare.signHash = signHash;
+                sigShare.sig = skShares[j].Sign(signHash);
+                sigShares.emplace_back(std::move(sigShare));
+            }
+        }
+
+        //printf("initialized sig shares quorum %d\n", quorumSize);
+    }
+
+    std::set<size_t> Verify(const std::vector<SigShare>& shares, bool parallel)
+    {
+        // same job splitting as in CSigSharesManager::ProcessPendingSigShares
+        std::map<uint256, std::vector<const SigShare*>> bySignHash;
+        for (auto& s : shares) {
+            bySignHash[s.signHash].emplace_back(&s);
+        }
+
+        size_t maxJobSize = parallel ? std::max((size_t)32, shares.size() / std::max(1, GetNumCores())) : shares.size();
+        std::vector<std::vector<const SigShare*>> jobs;
+        for (auto& p : bySignHash) {
+            auto& v = p.second;
+            for (size_t i = 0; i < v.size(); i += maxJobSize) {
+                jobs.emplace_back(v.begin() + i, v.begin() + std::min(v.size(), i + maxJobSize));
+            }
+        }
+        std::vector<std::set<size_t>> jobBadSources(jobs.size());
+
+        auto verifyJobs = [&](size_t start, size_t count) {
+            for (size_t i = start; i < start + count; i++) {
+                CBLSBatchVerifier<size_t, size_t> batchVerifier(false, true, 0, parallel ? &blsWorker : nullptr);
+                for (auto s : jobs[i]) {
+                    batchVerifier.PushMessage(s->source, s->member, s->signHash, s->sig, pubKeyShares[s->member]);
+                }
+                batchVerifier.Verify();
+                jobBadSources[i] = std::move(batchVerifier.badSources);
+            }
+        };
+
+        if (parallel) {
+            blsWorker.ParallelForBatches(jobs.size(), 1, verifyJobs);
+        } else {
+            verifyJobs(0, jobs.size());
+        }
+
+        std::set<size_t> badSources;
+        for (auto& s : jobBadSources) {
+            badSources.insert(s.begin(), s.end());
+        }
+        return badSources;
+    }
+
+    void Bench_Verify(benchmark::State& state, size_t invalidCount, bool parallel, const char* name)
+    {
+        size_t verifiedCount = 0;
+        int64_t verifyTime = 0;
+
+        while (state.KeepRunning()) {
+            auto shares = sigShares;
+
+            std::set<size_t> invalidSources;
+            for (size_t i = 0; i < invalidCount; i++) {
+                auto& s = shares[GetRandInt(shares.size())];
+                CBLSSecretKey sk;
+                sk.MakeNewKey();
+                s.sig = sk.Sign(s.signHash);
+                invalidSources.emplace(s.source);
+            }
+
+            int64_t nTime = GetTimeMicros();
+            auto badSources = Verify(shares, parallel);
+            verifyTime += GetTimeMicros() - nTime;
+            verifiedCount += shares.size();
+
+            assert(badSources == invalidSources);
+        }
+
+        if (verifyTime != 0) {
+            std::cout << name << ": " << (verifiedCount * 1000000 / verifyTime) << " shares/s" << std::endl;
+        }
+    }
+};
+
+std::shared_ptr<SigSharesQuorum> sigSharesQuorum400;
+
+static void InitSigSharesIfNeeded()
+{
+    if (sigSharesQuorum400 == nullptr) {
+        sigSharesQuorum400 = std::make_shared<SigSharesQuorum>(400);
+    }
+}
+
+void CleanupBLSSigSharesTests()
+{
+    sigSharesQuorum400.reset();
+}
+
+#define BENCH_VerifySigShares(name, quorumSize, invalidCount, parallel) \
+    static void BLSSigShares_Verify_##name##_##quorumSize(benchmark::State& state) \
+    { \
+        InitSigSharesIfNeeded(); \
+        sigSharesQuorum##quorumSize->Bench_Verify(state, invalidCount, parallel, "BLSSigShares_Verify_" #name "_" #quorumSize); \
+    } \
+    BENCHMARK(BLSSigShares_Verify_##name##_##quorumSize)
+
+BENCH_VerifySigShares(simple, 400, 0, false)
+BENCH_VerifySigShares(parallel, 400, 0, true)
+BENCH_VerifySigShares(simpleInvalid, 400, 5, false)
+BENCH_VerifySigShares(parallelInvalid, 400, 5, true)
+
+// The layout SigShareMap had before it was flattened, kept here to compare against
+template<typename T>
+struct NestedSigShareMap
+{
+    std::unordered_map<uint256, std::unordered_map<uint16_t, T>, StaticSaltedHasher> internalMap;
+
+    bool Add(const llmq::SigShareKey& k, const T& v) { return internalMap[k.first].emplace(k.second, v).second; }
+    bool Has(const llmq::SigShareKey& k) const
+    {
+        auto it = internalMap.find(k.first);
+        return it != internalMap.end() && it->second.count(k.second) != 0;
+    }
+    void EraseAllForSignHash(const uint256& signHash) { internalMap.erase(signHash); }
+    template<typename F>
+    void ForEach(F&& f)
+    {
+        for (auto& p : internalMap) {
+            for (auto& p2 : p.second) {
+                f(std::make_pair(p.first, p2.first), p2.second);
+            }
+        }
+    }
+    size_t DynamicUsage() const
+    {
+        size_t usage = memusage::DynamicUsage(internalMap);
+        for (auto& p : internalMap) {
+            usage += memusage::DynamicUsage(p.second);
+        }
+        return usage;
+    }
+};
+
+// Adds shares for a few sessions in random member order, looks all of them up, iterates them and finally erases all
+// sessions. This is roughly what happens to CSigSharesManager::sigShares while signing
+template<typename Map, typename T>
+static void Bench_SigShareMap(benchmark::State& state, const char* name)
+{
+    const size_t sessionCount = 32;
+    const size_t quorumSize = 400;
+
+    std::vector<uint256> signHashes(sessionCount);
+    std::vector<llmq::SigShareKey> keys;
+    for (auto& signHash : signHashes) {
+        signHash = GetRandHash();
+        for (size_t i = 0; i < quorumSize; i++) {
+            keys.emplace_back(signHash, (uint16_t)i);
+        }
+    }
+    std::random_shuffle(keys.begin(), keys.end(), GetRandInt);
+
+    int64_t addTime = 0, lookupTime = 0, iterateTime = 0, eraseTime = 0;
+    size_t usage = 0;
+    size_t found = 0;
+    size_t iterations = 0;
+    while (state.KeepRunning()) {
+        Map map;
+
+        int64_t nTime = GetTimeMicros();
+        for (auto& k : keys) {
+            map.Add(k, T());
+        }
+        int64_t nTime2 = GetTimeMicros();
+        for (auto& k : keys) {
+            found += map.Has(k);
+        }
+        int64_t nTime3 = GetTimeMicros();
+        map.ForEach([&](const llmq::SigShareKey& k, const T& v) {
+            found += k.second < quorumSize;
+        });
+        int64_t nTime4 = GetTimeMicros();
+        usage = map.DynamicUsage();
+        for (auto& signHash : signHashes) {
+            map.EraseAllForSignHash(signHash);
+        }
+        int64_t nTime5 = GetTimeMicros();
+
+        addTime += nTime2 - nTime;
+        lookupTime += nTime3 - nTime2;
+        iterateTime += nTime4 - nTime3;
+        eraseTime += nTime5 - nTime4;
+        iterations++;
+    }
+    assert(found == iterations * keys.size() * 2);
+
+    if (iterations != 0) {
+        std::cout << name << ": add=" << addTime / iterations << "us, lookup=" << lookupTime / iterations
+                  << "us, iterate=" << iterateTime / iterations << "us, erase=" << eraseTime / iterations
+                  << "us, memory=" << usage << " bytes" << std::endl;
+    }
+}
+
+#define BENCH_SigShareMap(name, T) \
+    static void SigShareMap_Nested_##name(benchmark::State& state) \
+    { \
+        Bench_SigShareMap<NestedSigShareMap<T>, T>(state, "SigShareMap_Nested_" #name); \
+    } \
+    static void SigShareMap_Flat_##name(benchmark::State& state) \
+    { \
+        Bench_SigShareMap<llmq::SigShareMap<T>, T>(state, "SigShareMap_Flat_" #name); \
+    } \
+    BENCHMARK(SigShareMap_Nested_##name); \
+    BENCHMARK(SigShareMap_Flat_##name)
+
+BENCH_SigShareMap(SigShare, llmq::CSigShare)
+BENCH_SigShareMap(Time, int64_t)
@@ -8,6 +8,8 @@
 #include "bench.h"
 #include "bloom.h"
 #include "hash.h"
+#include "primitives/block.h"
+#include "random.h"
 #include "uint256.h"
 #include "utiltime.h"
 #include "crypto/other/ripemd160.h"
@@ -42,6 +44,36 @@ static void HASH_SHA256(benchmark::State& state)
         CSHA256().Write(in.data(), in.size()).Finalize(hash);
 }
 
+// Run with only the given SHA256 backends enabled. A backend the CPU lacks falls back to the
+// next best one that is enabled, ending at the standard implementation.
+static void SHA256Backend(benchmark::State& state, sha256_implementation::UseImplementation use_implementation)
+{
+    uint8_t hash[CSHA256::OUTPUT_SIZE];
+    std::vector<uint8_t> in(BUFFER_SIZE,0);
+    SHA256AutoDetect(use_implementation);
+    while (state.KeepRunning())
+        CSHA256().Write(in.data(), in.size()).Finalize(hash);
+    SHA256AutoDetect();
+}
+
+static void SHA256D64Backend(benchmark::State& state, sha256_implementation::UseImplementation use_implementation)
+{
+    std::vector<uint8_t> in(64 * 1024, 0);
+    SHA256AutoDetect(use_implementation);
+    while (state.KeepRunning())
+        SHA256D64(in.data(), in.data(), 1024);
+    SHA256AutoDetect();
+}
+
+static void HASH_SHA256_standard(benchmark::State& state) { SHA256Backend(state, sha256_implementation::STANDARD); }
+static void HASH_SHA256_shani(benchmark::State& state) { SHA256Backend(state, sha256_implementation::USE_SHANI); }
+
+static void HASH_SHA256D64_1024_standard(benchmark::State& state) { SHA256D64Backend(state, sha256_implementation::STANDARD); }
+static void HASH_SHA256D64_1024_sse41(benchmark::State& state) { SHA256D64Backend(state, sha256_implementation::USE_SSE4); }
+static void HASH_SHA256D64_1024_avx2(benchmark::State& state) { SHA256D64Backend(state, sha256_implementation::USE_AVX2); }
+static void HASH_SHA256D64_1024_shani(benchmark::State& state) { SHA256D64Backend(state, sha256_implementation::USE_SHANI); }
+static void HASH_SHA256D64_1024(benchmark::State& state) { SHA256D64Backend(state, sha256_implementation::USE_ALL); }
+
 static void HASH_SHA256_0032b(benchmark::State& state)
 {
     std::vector<uint8_t> in(32,0);
@@ -186,9 +218,77 @@ static void HASH_X11_2048b_single(benchmark::State& state)
         hash = HashHoneyComb(in.begin(), in.end());
 }
 
+/* HoneyComb over header-sized inputs with a single reused hasher, as done when validating many headers */
+static void HASH_HoneyComb_0080b_reused(benchmark::State& state)
+{
+    CHoneyCombHasher hasher;
+    std::vector<uint8_t> in(80,0);
+    while (state.KeepRunning()) {
+        for (int i = 0; i < 1000; i++) {
+            hasher.Reset().Write(in.data(), in.size()).Finalize(&in[0]);
+        }
+    }
+}
+
+static void HASH_HoneyComb_2048b_reused(benchmark::State& state)
+{
+    CHoneyCombHasher hasher;
+    std::vector<uint8_t> in(2048,0);
+    while (state.KeepRunning())
+        hasher.Reset().Write(in.data(), in.size()).Finalize(&in[0]);
+}
+
+static std::vector<CBlockHeader> MakeHeaders(size_t n)
+{
+    std::vector<CBlockHeader> headers(n);
+    for (size_t i = 0; i < n; i++) {
+        headers[i].nVersion = 0x20000000;
+        headers[i].hashPrevBlock = GetRandHash();
+        headers[i].hashMerkleRoot = GetRandHash();
+        headers[i].nTime = 1600000000 + i;
+        headers[i].nBits = 0x1e0ffff0;
+        headers[i].nNonce = i;
+    }
+    return headers;
+}
+
+static void HoneyCombHeadersSingle(benchmark::State& state, size_t n)
+{
+    std::vector<CBlockHeader> headers = MakeHeaders(n);
+    std::vector<uint256> hashes(n);
+    while (state.KeepRunning()) {
+        for (size_t i = 0; i < n; i++) {
+            hashes[i] = headers[i].GetHash();
+        }
+    }
+}
+
+static void HoneyCombHeadersBatch(benchmark::State& state, size_t n)
+{
+    std::vector<CBlockHeader> headers = MakeHeaders(n);
+    std::vector<uint256> hashes(n);
+    while (state.KeepRunning()) {
+        HashHoneyCombBatch(headers.data(), n, hashes.data());
+    }
+}
+
+static void HASH_HoneyComb_Headers_0001_single(benchmark::State& state) { HoneyCombHeadersSingle(state, 1); }
+static void HASH_HoneyComb_Headers_0001_batch(benchmark::State& state) { HoneyCombHeadersBatch(state, 1); }
+static void HASH_HoneyComb_Headers_0008_single(benchmark::State& state) { HoneyCombHeadersSingle(state, 8); }
+static void HASH_HoneyComb_Headers_0008_batch(benchmark::State& state) { HoneyCombHeadersBatch(state, 8); }
+static void HASH_HoneyComb_Headers_2000_single(benchmark::State& state) { HoneyCombHeadersSingle(state, 2000); }
+static void HASH_HoneyComb_Headers_2000_batch(benchmark::State& state) { HoneyCombHeadersBatch(state, 2000); }
+
 BENCHMARK(HASH_RIPEMD160);
 BENCHMARK(HASH_SHA1);
 BENCHMARK(HASH_SHA256);
+BENCHMARK(HASH_SHA256_standard);
+BENCHMARK(HASH_SHA256_shani);
+BENCHMARK(HASH_SHA256D64_1024);
+BENCHMARK(HASH_SHA256D64_1024_standard);
+BENCHMARK(HASH_SHA256D64_1024_sse41);
+BENCHMARK(HASH_SHA256D64_1024_avx2);
+BENCHMARK(HASH_SHA256D64_1024_shani);
 BENCHMARK(HASH_DSHA256);
 BENCHMARK(HASH_SHA512);
 BENCHMARK(HASH_X11);
@@ -209,3 +309,12 @@ BENCHMARK(HASH_X11_0128b_single);
 BENCHMARK(HASH_X11_0512b_single);
 BENCHMARK(HASH_X11_1024b_single);
 BENCHMARK(HASH_X11_2048b_single);
+BENCHMARK(HASH_HoneyComb_0080b_reused);
+BENCHMARK(HASH_HoneyComb_2048b_reused);
+
+BENCHMARK(HASH_HoneyComb_Headers_0001_single);
+BENCHMARK(HASH_HoneyComb_Headers_0001_batch);
+BENCHMARK(HASH_HoneyComb_Headers_0008_single);
+BENCHMARK(HASH_HoneyComb_Headers_0008_batch);
+BENCHMARK(HASH_HoneyComb_Headers_2000_single);
+BENCHMARK(HASH_HoneyComb_Headers_2000_batch);
@@ -0,0 +1,156 @@
+// Copyright (c) 2020 The BeeGroup developers are EternityGroup
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "random.h"
+#include "script/standard.h"
+
+#include "evo/deterministicmns.h"
+
+static const size_t MN_LIST_SIZE = 5000;
+static const size_t LOOKUPS_PER_ITERATION = 100;
+
+struct MNListTestData
+{
+    CDeterministicMNList mnList;
+    std::vector<CBLSPublicKey> operatorKeys;
+    std::vector<CScript> payoutScripts;
+    std::vector<CKeyID> votingKeys;
+};
+
+static CKeyID RandomKeyID()
+{
+    uint256 h = GetRandHash();
+    return CKeyID(uint160(std::vector<unsigned char>(h.begin(), h.begin() + 20)));
+}
+
+static const MNListTestData& GetMNListTestData()
+{
+    static MNListTestData data;
+    if (!data.operatorKeys.empty()) {
+        return data;
+    }
+
+    data.mnList = CDeterministicMNList(uint256(), 0, 0);
+    for (size_t i = 0; i < MN_LIST_SIZE; i++) {
+        CBLSSecretKey operatorKey;
+        operatorKey.MakeNewKey();
+
+        auto dmn = std::make_shared<CDeterministicMN>();
+        dmn->proTxHash = GetRandHash();
+        dmn->internalId = i;
+        dmn->collateralOutpoint = COutPoint(GetRandHash(), 0);
+        auto dmnState = std::make_shared<CDeterministicMNState>();
+        dmnState->keyIDOwner = RandomKeyID();
+        dmnState->pubKeyOperator.Set(operatorKey.GetPublicKey());
+        dmnState->keyIDVoting = RandomKeyID();
+        dmnState->scriptPayout = GetScriptForDestination(RandomKeyID());
+        dmn->pdmnState = dmnState;
+        data.mnList.AddMN(dmn);
+
+        data.operatorKeys.emplace_back(operatorKey.GetPublicKey());
+        data.payoutScripts.emplace_back(dmnState->scriptPayout);
+        data.votingKeys.emplace_back(dmnState->keyIDVoting);
+    }
+    return data;
+}
+
+// The Scan variants do what the lookups did before the secondary indexes were added
+
+static void DeterministicMNList_OperatorKey_Scan(benchmark::State& state)
+{
+    const auto& data = GetMNListTestData();
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        for (size_t j = 0; j < LOOKUPS_PER_ITERATION; j++, i++) {
+            const auto& pubKey = data.operatorKeys[i % data.operatorKeys.size()];
+            CDeterministicMNCPtr found;
+            data.mnList.ForEachMN(false, [&](const CDeterministicMNCPtr& dmn) {
+                if (!found && dmn->pdmnState->pubKeyOperator.Get() == pubKey) {
+                    found = dmn;
+                }
+            });
+            assert(found);
+        }
+    }
+}
+
+static void DeterministicMNList_OperatorKey_Indexed(benchmark::State& state)
+{
+    const auto& data = GetMNListTestData();
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        for (size_t j = 0; j < LOOKUPS_PER_ITERATION; j++, i++) {
+            auto found = data.mnList.GetMNByOperatorKey(data.operatorKeys[i % data.operatorKeys.size()]);
+            assert(found);
+        }
+    }
+}
+
+static void DeterministicMNList_PayoutScript_Scan(benchmark::State& state)
+{
+    const auto& data = GetMNListTestData();
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        for (size_t j = 0; j < LOOKUPS_PER_ITERATION; j++, i++) {
+            const auto& script = data.payoutScripts[i % data.payoutScripts.size()];
+            std::vector<CDeterministicMNCPtr> found;
+            data.mnList.ForEachMN(false, [&](const CDeterministicMNCPtr& dmn) {
+                if (dmn->pdmnState->scriptPayout == script) {
+                    found.emplace_back(dmn);
+                }
+            });
+            assert(!found.empty());
+        }
+    }
+}
+
+static void DeterministicMNList_PayoutScript_Indexed(benchmark::State& state)
+{
+    const auto& data = GetMNListTestData();
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        for (size_t j = 0; j < LOOKUPS_PER_ITERATION; j++, i++) {
+            auto found = data.mnList.GetMNsByPayoutScript(data.payoutScripts[i % data.payoutScripts.size()]);
+            assert(!found.empty());
+        }
+    }
+}
+
+static void DeterministicMNList_VotingKey_Scan(benchmark::State& state)
+{
+    const auto& data = GetMNListTestData();
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        for (size_t j = 0; j < LOOKUPS_PER_ITERATION; j++, i++) {
+            const auto& keyID = data.votingKeys[i % data.votingKeys.size()];
+            std::vector<CDeterministicMNCPtr> found;
+            data.mnList.ForEachMN(false, [&](const CDeterministicMNCPtr& dmn) {
+                if (dmn->pdmnState->keyIDVoting == keyID) {
+                    found.emplace_back(dmn);
+                }
+            });
+            assert(!found.empty());
+        }
+    }
+}
+
+static void DeterministicMNList_VotingKey_Indexed(benchmark::State& state)
+{
+    const auto& data = GetMNListTestData();
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        for (size_t j = 0; j < LOOKUPS_PER_ITERATION; j++, i++) {
+            auto found = data.mnList.GetMNsByVotingKey(data.votingKeys[i % data.votingKeys.size()]);
+            assert(!found.empty());
+        }
+    }
+}
+
+BENCHMARK(DeterministicMNList_OperatorKey_Scan);
+BENCHMARK(DeterministicMNList_OperatorKey_Indexed);
+BENCHMARK(DeterministicMNList_PayoutScript_Scan);
+BENCHMARK(DeterministicMNList_PayoutScript_Indexed);
+BENCHMARK(DeterministicMNList_VotingKey_Scan);
+BENCHMARK(DeterministicMNList_VotingKey_Indexed);
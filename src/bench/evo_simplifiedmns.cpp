@@ -0,0 +1,81 @@
+// Copyright (c) 2020 The BeeGroup developers are EternityGroup
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "netbase.h"
+#include "random.h"
+#include "tinyformat.h"
+
+#include "evo/simplifiedmns.h"
+
+static const size_t SML_SIZE = 5000;
+
+static const std::vector<CSimplifiedMNListEntry>& GetSMLEntries()
+{
+    static std::vector<CSimplifiedMNListEntry> entries;
+    if (!entries.empty()) {
+        return entries;
+    }
+
+    for (size_t i = 0; i < SML_SIZE; i++) {
+        CSimplifiedMNListEntry smle;
+        smle.proRegTxHash = GetRandHash();
+        smle.confirmedHash = GetRandHash();
+        std::string ip = strprintf("%d.%d.%d.%d", 10, (i >> 16) & 0xff, (i >> 8) & 0xff, i & 0xff);
+        Lookup(ip.c_str(), smle.service, 9999, false);
+        uint256 votingHash = GetRandHash();
+        smle.keyIDVoting = CKeyID(uint160(std::vector<unsigned char>(votingHash.begin(), votingHash.begin() + 20)));
+        smle.isValid = true;
+        entries.emplace_back(smle);
+    }
+    return entries;
+}
+
+// Calculates the merkle root of the whole list, as done for every block before the incremental tree was added
+static void SimplifiedMNListMerkleRoot_Full(benchmark::State& state)
+{
+    CSimplifiedMNList sml(GetSMLEntries());
+    while (state.KeepRunning()) {
+        sml.CalcMerkleRoot(nullptr);
+    }
+}
+
+// Alternates between two lists which differ in nChanged entries, so that every update rehashes nChanged entries
+static void SimplifiedMNListMerkleRoot_Incremental(benchmark::State& state, size_t nChanged)
+{
+    auto changedEntries = GetSMLEntries();
+    for (size_t i = 0; i < nChanged; i++) {
+        changedEntries[i * (SML_SIZE / nChanged)].isValid = false;
+    }
+    CSimplifiedMNList smls[2] = {CSimplifiedMNList(GetSMLEntries()), CSimplifiedMNList(changedEntries)};
+
+    CSimplifiedMNListMerkleTree tree;
+    tree.Update(smls[0]);
+
+    size_t i = 0;
+    while (state.KeepRunning()) {
+        tree.Update(smls[++i & 1]);
+        tree.GetRoot();
+    }
+}
+
+static void SimplifiedMNListMerkleRoot_Incremental_1(benchmark::State& state)
+{
+    SimplifiedMNListMerkleRoot_Incremental(state, 1);
+}
+
+static void SimplifiedMNListMerkleRoot_Incremental_10(benchmark::State& state)
+{
+    SimplifiedMNListMerkleRoot_Incremental(state, 10);
+}
+
+static void SimplifiedMNListMerkleRoot_Incremental_100(benchmark::State& state)
+{
+    SimplifiedMNListMerkleRoot_Incremental(state, 100);
+}
+
+BENCHMARK(SimplifiedMNListMerkleRoot_Full);
+BENCHMARK(SimplifiedMNListMerkleRoot_Incremental_1);
+BENCHMARK(SimplifiedMNListMerkleRoot_Incremental_10);
+BENCHMARK(SimplifiedMNListMerkleRoot_Incremental_100);
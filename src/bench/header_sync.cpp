@@ -0,0 +1,109 @@
+// Copyright (c) 2020 The BeeGroup developers are EternityGroup
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "arith_uint256.h"
+#include "chainparams.h"
+#include "consensus/validation.h"
+#include "pow.h"
+#include "util.h"
+#include "utiltime.h"
+#include "validation.h"
+#include "versionbits.h"
+
+#include "llmq/quorums_chainlocks.h"
+
+#include <boost/thread.hpp>
+
+static const int HEADER_SYNC_COUNT = 500000;
+
+// Mine a regtest header chain on top of genesis. Headers are spaced more than 4 target spacings
+// apart, which keeps DGW at the regtest PoW limit so that every header takes ~2 hashes to mine.
+static std::vector<CBlockHeader> MineRegtestHeaders(const CChainParams& chainparams, int count)
+{
+    const Consensus::Params& params = chainparams.GetConsensus();
+    const int64_t nSpacing = params.nPowTargetSpacing * 4 + 1;
+    const uint32_t nBits = UintToArith256(params.powLimit).GetCompact();
+
+    std::vector<CBlockHeader> headers;
+    headers.reserve(count);
+
+    uint256 hashPrev = chainparams.GenesisBlock().GetHash();
+    int64_t nTime = chainparams.GenesisBlock().GetBlockTime();
+    for (int i = 0; i < count; i++) {
+        CBlockHeader header;
+        header.nVersion = VERSIONBITS_TOP_BITS;
+        header.hashPrevBlock = hashPrev;
+        header.hashMerkleRoot = ArithToUint256(arith_uint256(i));
+        header.nTime = nTime += nSpacing;
+        header.nBits = nBits;
+        header.nNonce = 0;
+        while (!CheckProofOfWork(hashPrev = header.GetHash(), header.nBits, params)) {
+            header.nNonce++;
+        }
+        headers.push_back(header);
+    }
+    return headers;
+}
+
+// Sync HEADER_SYNC_COUNT headers into an empty block index, in headers messages of MAX_HEADERS_RESULTS
+static void HeaderSync(benchmark::State& state, bool fParallel)
+{
+    SelectParams(CBaseChainParams::REGTEST);
+    const CChainParams& chainparams = Params();
+
+    static std::vector<std::vector<CBlockHeader>> messages;
+    if (messages.empty()) {
+        std::vector<CBlockHeader> headers = MineRegtestHeaders(chainparams, HEADER_SYNC_COUNT);
+        for (size_t pos = 0; pos < headers.size(); pos += MAX_HEADERS_RESULTS) {
+            size_t end = std::min(headers.size(), pos + MAX_HEADERS_RESULTS);
+            messages.emplace_back(headers.begin() + pos, headers.begin() + end);
+        }
+    }
+    const std::vector<CBlockHeader> genesis(1, chainparams.GenesisBlock().GetBlockHeader());
+
+    int nScriptCheckThreadsPrev = nScriptCheckThreads;
+    boost::thread_group threadGroup;
+    nScriptCheckThreads = fParallel ? std::max(2, GetNumCores()) : 0;
+    for (int i = 0; i < nScriptCheckThreads - 1; i++) {
+        threadGroup.create_thread(&ThreadHeaderCheck);
+    }
+
+    llmq::chainLocksHandler = new llmq::CChainLocksHandler(nullptr);
+    SetMockTime(messages.back().back().GetBlockTime());
+
+    while (state.KeepRunning()) {
+        UnloadBlockIndex();
+
+        CValidationState validationState;
+        bool fAccepted = ProcessNewBlockHeaders(genesis, validationState, chainparams);
+        for (const auto& headers : messages) {
+            fAccepted &= ProcessNewBlockHeaders(headers, validationState, chainparams);
+        }
+        assert(fAccepted);
+    }
+
+    UnloadBlockIndex();
+    SetMockTime(0);
+    delete llmq::chainLocksHandler;
+    llmq::chainLocksHandler = nullptr;
+
+    threadGroup.interrupt_all();
+    threadGroup.join_all();
+    nScriptCheckThreads = nScriptCheckThreadsPrev;
+}
+
+static void HeaderSync_500k_Serial(benchmark::State& state)
+{
+    HeaderSync(state, false);
+}
+
+static void HeaderSync_500k_Parallel(benchmark::State& state)
+{
+    HeaderSync(state, true);
+}
+
+BENCHMARK(HeaderSync_500k_Serial);
+BENCHMARK(HeaderSync_500k_Parallel);
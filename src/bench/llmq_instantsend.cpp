@@ -0,0 +1,303 @@
+// Copyright (c) 2020 The BeeGroup developers are EternityGroup
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+#include "random.h"
+#include "bls/bls_batchverifier.h"
+#include "bls/bls_worker.h"
+#include "dbwrapper.h"
+#include "llmq/quorums_instantsend.h"
+#include "llmq/quorums_utils.h"
+#include "memusage.h"
+#include "primitives/transaction.h"
+#include "script/script.h"
+#include "utiltime.h"
+
+#include <boost/filesystem.hpp>
+
+#include <iostream>
+
+extern CBLSWorker blsWorker;
+
+// same as INPUTLOCK_REQUESTID_PREFIX in llmq/quorums_instantsend.cpp
+static const std::string INPUTLOCK_REQUESTID_PREFIX = "inlock";
+
+/**
+ * Load generator for the InstantSend locking path. Transactions are driven through the same steps a masternode
+ * performs, but without networking and chain state:
+ *  1. ProcessTx: sign our share for every input lock
+ *  2. verify the other members' input lock shares and recover the input lock signatures
+ *  3. TrySignInstantSendLock: sign our islock share, verify the other members' shares and recover the islock signature
+ *  4. ProcessPendingInstantSendLocks: batch verify the islock like a receiving node and store it in CInstantSendDb
+ *
+ * Each benchmark iteration is one tick of the worker threads. Every tick, new TXs arrive and all TXs in flight advance
+ * by one step, which is roughly how TXs, sig shares and islocks queue up between the worker threads of a real node.
+ * A regtest sized quorum (LLMQ_5_60) is used. The shares of the other members are created up front.
+ */
+class ISLockPipeline
+{
+    static const Consensus::LLMQType LLMQ_TYPE = Consensus::LLMQ_5_60;
+    static const int QUORUM_SIZE = 5;
+    static const int THRESHOLD = 3;
+    static const size_t TX_POOL_SIZE = 2000;
+
+    struct Session
+    {
+        uint256 signHash;
+        // shares of the members 1..THRESHOLD-1, we are member 0
+        std::vector<CBLSSignature> otherShares;
+    };
+
+    struct TxData
+    {
+        CTransactionRef tx;
+        std::vector<Session> inputSessions;
+        Session islockSession;
+        llmq::CInstantSendLock islock;
+    };
+
+    struct InFlightTx
+    {
+        const TxData* data;
+        int64_t nTimeReceived;
+        // our shares for the input locks, then the recovered input lock signatures
+        std::vector<CBLSSignature> inputSigs;
+        llmq::CInstantSendLock islock;
+    };
+
+    uint256 quorumHash;
+    std::vector<CBLSId> ids;
+    BLSSecretKeyVector skShares;
+    BLSPublicKeyVector pubKeyShares;
+    CBLSPublicKey quorumPublicKey;
+
+    std::vector<TxData> txPool;
+
+public:
+    ISLockPipeline()
+    {
+        quorumHash = GetRandHash();
+        ids.resize(QUORUM_SIZE);
+        for (int i = 0; i < QUORUM_SIZE; i++) {
+            ids[i].SetHash(GetRandHash());
+        }
+
+        BLSVerificationVectorPtr vvec;
+        blsWorker.GenerateContributions(THRESHOLD, ids, vvec, skShares);
+        quorumPublicKey = (*vvec)[0];
+        pubKeyShares.resize(QUORUM_SIZE);
+        for (int i = 0; i < QUORUM_SIZE; i++) {
+            pubKeyShares[i] = blsWorker.BuildPubKeyShare(vvec, ids[i]);
+        }
+
+        txPool.resize(TX_POOL_SIZE);
+        for (auto& d : txPool) {
+            CMutableTransaction mtx;
+            mtx.vin.resize(1 + GetRandInt(3));
+            for (auto& in : mtx.vin) {
+                in.prevout = COutPoint(GetRandHash(), GetRandInt(4));
+            }
+            mtx.vout.emplace_back(COIN, CScript() << OP_TRUE);
+            d.tx = MakeTransactionRef(mtx);
+
+            for (auto& in : d.tx->vin) {
+                auto id = ::SerializeHash(std::make_pair(INPUTLOCK_REQUESTID_PREFIX, in.prevout));
+                d.inputSessions.emplace_back(MakeSession(id, d.tx->GetHash()));
+                d.islock.inputs.emplace_back(in.prevout);
+            }
+            d.islock.txid = d.tx->GetHash();
+            d.islockSession = MakeSession(d.islock.GetRequestId(), d.islock.txid);
+        }
+    }
+
+    void Bench_Pipeline(benchmark::State& state, size_t txsPerTick, const char* name)
+    {
+        CDBWrapper db(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path(), 8 << 20, true);
+        llmq::CInstantSendDb isDb(db);
+
+        // stages[i] holds the TXs which will go through step i + 1 in the next tick
+        std::vector<std::vector<InFlightTx>> stages(4);
+        std::vector<int64_t> latencies;
+        size_t nextTx = 0;
+        size_t maxUsage = 0;
+        size_t found = 0;
+
+        int64_t nTimeStart = GetTimeMicros();
+        while (state.KeepRunning()) {
+            int64_t nTimeTick = GetTimeMicros();
+
+            // walk the stages backwards, so that each TX advances by exactly one step per tick
+            auto done = ProcessISLocks(isDb, std::move(stages[3]), found);
+            int64_t nTimeDone = GetTimeMicros();
+            for (auto& t : done) {
+                latencies.emplace_back(nTimeDone - t.nTimeReceived);
+            }
+            stages[3] = CreateISLocks(std::move(stages[2]));
+            stages[2] = RecoverInputLocks(std::move(stages[1]));
+            stages[1] = SignInputLocks(std::move(stages[0]));
+
+            stages[0].clear();
+            for (size_t i = 0; i < txsPerTick; i++) {
+                stages[0].push_back({&txPool[nextTx], nTimeTick, {}, {}});
+                nextTx = (nextTx + 1) % txPool.size();
+            }
+
+            maxUsage = std::max(maxUsage, GetInFlightUsage(stages));
+        }
+        int64_t totalTime = GetTimeMicros() - nTimeStart;
+
+        // TXs in the pool are reused, so the lookups must always succeed
+        assert(found == latencies.size());
+
+        if (latencies.empty() || totalTime == 0) {
+            return;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        std::cout << name << ": " << (latencies.size() * 1000000 / totalTime) << " islocks/s"
+                  << ", p50=" << latencies[latencies.size() / 2] << "us"
+                  << ", p99=" << latencies[latencies.size() * 99 / 100] << "us"
+                  << ", inFlightMemory=" << maxUsage << " bytes" << std::endl;
+    }
+
+private:
+    Session MakeSession(const uint256& id, const uint256& msgHash)
+    {
+        Session s;
+        s.signHash = llmq::CLLMQUtils::BuildSignHash(LLMQ_TYPE, quorumHash, id, msgHash);
+        for (int i = 1; i < THRESHOLD; i++) {
+            s.otherShares.emplace_back(skShares[i].Sign(s.signHash));
+        }
+        return s;
+    }
+
+    // Verifies the shares of the other members in one batch, like CSigSharesManager::ProcessPendingSigShares does
+    void VerifyShares(const std::vector<const Session*>& sessions)
+    {
+        CBLSBatchVerifier<int, std::pair<size_t, int>> batchVerifier(false, true, 0, &blsWorker);
+        for (size_t i = 0; i < sessions.size(); i++) {
+            for (int j = 1; j < THRESHOLD; j++) {
+                batchVerifier.PushMessage(j, std::make_pair(i, j), sessions[i]->signHash, sessions[i]->otherShares[j - 1], pubKeyShares[j]);
+            }
+        }
+        batchVerifier.Verify();
+        assert(batchVerifier.badSources.empty());
+    }
+
+    CBLSSignature Recover(const CBLSSignature& ownShare, const Session& session)
+    {
+        std::vector<CBLSSignature> shares;
+        shares.reserve(THRESHOLD);
+        shares.emplace_back(ownShare);
+        shares.insert(shares.end(), session.otherShares.begin(), session.otherShares.end());
+
+        CBLSSignature sig;
+        bool ok = sig.Recover(shares, std::vector<CBLSId>(ids.begin(), ids.begin() + THRESHOLD));
+        assert(ok);
+        return sig;
+    }
+
+    std::vector<InFlightTx> SignInputLocks(std::vector<InFlightTx> txs)
+    {
+        for (auto& t : txs) {
+            for (auto& s : t.data->inputSessions) {
+                t.inputSigs.emplace_back(skShares[0].Sign(s.signHash));
+            }
+        }
+        return txs;
+    }
+
+    std::vector<InFlightTx> RecoverInputLocks(std::vector<InFlightTx> txs)
+    {
+        std::vector<const Session*> sessions;
+        for (auto& t : txs) {
+            for (auto& s : t.data->inputSessions) {
+                sessions.emplace_back(&s);
+            }
+        }
+        VerifyShares(sessions);
+
+        for (auto& t : txs) {
+            for (size_t i = 0; i < t.inputSigs.size(); i++) {
+                t.inputSigs[i] = Recover(t.inputSigs[i], t.data->inputSessions[i]);
+            }
+        }
+        return txs;
+    }
+
+    std::vector<InFlightTx> CreateISLocks(std::vector<InFlightTx> txs)
+    {
+        std::vector<const Session*> sessions;
+        for (auto& t : txs) {
+            sessions.emplace_back(&t.data->islockSession);
+        }
+        VerifyShares(sessions);
+
+        for (auto& t : txs) {
+            auto& session = t.data->islockSession;
+            t.islock = t.data->islock;
+            t.islock.sig.Set(Recover(skShares[0].Sign(session.signHash), session));
+        }
+        return txs;
+    }
+
+    std::vector<InFlightTx> ProcessISLocks(llmq::CInstantSendDb& isDb, std::vector<InFlightTx> txs, size_t& found)
+    {
+        // same as CInstantSendManager::ProcessPendingInstantSendLocks
+        CBLSBatchVerifier<NodeId, uint256> batchVerifier(false, true, 8);
+        std::vector<uint256> hashes;
+        hashes.reserve(txs.size());
+        for (auto& t : txs) {
+            hashes.emplace_back(::SerializeHash(t.islock));
+            batchVerifier.PushMessage(0, hashes.back(), t.data->islockSession.signHash, t.islock.sig.Get(), quorumPublicKey);
+        }
+        batchVerifier.Verify();
+        assert(batchVerifier.badMessages.empty());
+
+        for (size_t i = 0; i < txs.size(); i++) {
+            auto& islock = txs[i].islock;
+            isDb.WriteNewInstantSendLock(hashes[i], islock);
+
+            // conflict and lock checks done for new TXs and blocks
+            bool locked = isDb.GetInstantSendLockHashByTxid(islock.txid) == hashes[i];
+            for (auto& in : islock.inputs) {
+                locked &= isDb.GetInstantSendLockByInput(in) != nullptr;
+            }
+            found += locked;
+        }
+        return txs;
+    }
+
+    size_t GetInFlightUsage(const std::vector<std::vector<InFlightTx>>& stages) const
+    {
+        size_t usage = 0;
+        for (auto& v : stages) {
+            usage += memusage::DynamicUsage(v);
+            for (auto& t : v) {
+                usage += memusage::DynamicUsage(t.inputSigs) + memusage::DynamicUsage(t.islock.inputs);
+            }
+        }
+        return usage;
+    }
+};
+
+static std::shared_ptr<ISLockPipeline> isLockPipeline;
+
+void CleanupInstantSendTests()
+{
+    isLockPipeline.reset();
+}
+
+#define BENCH_ISLockPipeline(txsPerTick) \
+    static void InstantSend_Pipeline_##txsPerTick(benchmark::State& state) \
+    { \
+        if (isLockPipeline == nullptr) { \
+            isLockPipeline = std::make_shared<ISLockPipeline>(); \
+        } \
+        isLockPipeline->Bench_Pipeline(state, txsPerTick, "InstantSend_Pipeline_" #txsPerTick); \
+    } \
+    BENCHMARK(InstantSend_Pipeline_##txsPerTick)
+
+BENCH_ISLockPipeline(10)
+BENCH_ISLockPipeline(100)
+BENCH_ISLockPipeline(1000)
@@ -6,6 +6,7 @@
 #define BEENODE_CRYPTO_BLS_BATCHVERIFIER_H
 
 #include "bls.h"
+#include "bls_worker.h"
 
 #include <map>
 #include <vector>
@@ -28,6 +29,8 @@ private:
     bool secureVerification;
     bool perMessageFallback;
     size_t subBatchSize;
+    // if set, sources are verified in parallel when the whole batch turns out to be invalid
+    CBLSWorker* worker;
 
     MessageMap messages;
     MessagesBySourceMap messagesBySource;
@@ -37,10 +40,11 @@ public:
     std::set<MessageId> badMessages;
 
 public:
-    CBLSBatchVerifier(bool _secureVerification, bool _perMessageFallback, size_t _subBatchSize = 0) :
+    CBLSBatchVerifier(bool _secureVerification, bool _perMessageFallback, size_t _subBatchSize = 0, CBLSWorker* _worker = nullptr) :
             secureVerification(_secureVerification),
             perMessageFallback(_perMessageFallback),
-            subBatchSize(_subBatchSize)
+            subBatchSize(_subBatchSize),
+            worker(_worker)
     {
     }
 
@@ -77,44 +81,66 @@ public:
         }
 
         // revert to per-source verification
-        for (const auto& p : messagesBySource) {
-            bool batchValid = false;
-
-            // no need to verify it again if there was just one source
-            if (messagesBySource.size() != 1) {
-                byMessageHash.clear();
-                for (auto it = p.second.begin(); it != p.second.end(); ++it) {
-                    byMessageHash[(*it)->second.msgHash].emplace_back(*it);
-                }
-                batchValid = VerifyBatch(byMessageHash);
+        // sources are independent from each other, so they are bisected in parallel if we have worker threads
+        std::vector<typename MessagesBySourceMap::const_iterator> sources;
+        sources.reserve(messagesBySource.size());
+        for (auto it = messagesBySource.cbegin(); it != messagesBySource.cend(); ++it) {
+            sources.emplace_back(it);
+        }
+        std::vector<char> sourceValid(sources.size(), 0);
+        std::vector<std::vector<MessageId>> sourceBadMessages(sources.size());
+
+        auto verifySources = [&](size_t start, size_t count) {
+            for (size_t i = start; i < start + count; i++) {
+                sourceValid[i] = VerifySource(sources[i]->second, sourceBadMessages[i]);
+            }
+        };
+        if (worker && sources.size() > 1) {
+            worker->ParallelForBatches(sources.size(), 1, verifySources);
+        } else {
+            verifySources(0, sources.size());
+        }
+
+        for (size_t i = 0; i < sources.size(); i++) {
+            if (!sourceValid[i]) {
+                badSources.emplace(sources[i]->first);
+                badMessages.insert(sourceBadMessages[i].begin(), sourceBadMessages[i].end());
+            }
+        }
+    }
+
+private:
+    // Verifies all messages of a single source. Must not modify any members as it might be called from multiple threads
+    bool VerifySource(const std::vector<MessageMapIterator>& sourceMessages, std::vector<MessageId>& retBadMessages)
+    {
+        // no need to verify it again if there was just one source
+        if (messagesBySource.size() != 1) {
+            std::map<uint256, std::vector<MessageMapIterator>> byMessageHash;
+            for (auto it = sourceMessages.begin(); it != sourceMessages.end(); ++it) {
+                byMessageHash[(*it)->second.msgHash].emplace_back(*it);
+            }
+            if (VerifyBatch(byMessageHash)) {
+                return true;
             }
-            if (!batchValid) {
-                badSources.emplace(p.first);
-
-                if (perMessageFallback) {
-                    // revert to per-message verification
-                    if (p.second.size() == 1) {
-                        // no need to re-verify a single message
-                        badMessages.emplace(p.second[0]->second.msgId);
-                    } else {
-                        for (const auto& msgIt : p.second) {
-                            if (badMessages.count(msgIt->first)) {
-                                // same message might be invalid from different source, so no need to re-verify it
-                                continue;
-                            }
-
-                            const auto& msg = msgIt->second;
-                            if (!msg.sig.VerifyInsecure(msg.pubKey, msg.msgHash)) {
-                                badMessages.emplace(msg.msgId);
-                            }
-                        }
+        }
+
+        if (perMessageFallback) {
+            // revert to per-message verification
+            if (sourceMessages.size() == 1) {
+                // no need to re-verify a single message
+                retBadMessages.emplace_back(sourceMessages[0]->second.msgId);
+            } else {
+                for (const auto& msgIt : sourceMessages) {
+                    const auto& msg = msgIt->second;
+                    if (!msg.sig.VerifyInsecure(msg.pubKey, msg.msgHash)) {
+                        retBadMessages.emplace_back(msg.msgId);
                     }
                 }
             }
         }
+        return false;
     }
 
-private:
     // All Verify methods take ownership of the passed byMessageHash map and thus might modify the map. This is to avoid
     // unnecessary copies
 
@@ -72,6 +72,57 @@ void CBLSWorker::Stop()
     workerPool.stop(true);
 }
 
+void CBLSWorker::ParallelForBatches(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& func)
+{
+    struct BatchesState {
+        size_t count;
+        size_t batchSize;
+        size_t batchCount;
+        std::function<void(size_t, size_t)> func;
+        std::atomic<size_t> nextBatch{0};
+        std::atomic<size_t> inProgress{0};
+
+        // returns false when there are no batches left
+        bool RunNextBatch()
+        {
+            inProgress++;
+            size_t batch = nextBatch++;
+            if (batch >= batchCount) {
+                inProgress--;
+                return false;
+            }
+            size_t start = batch * batchSize;
+            func(start, std::min(batchSize, count - start));
+            inProgress--;
+            return true;
+        }
+    };
+
+    if (count == 0) {
+        return;
+    }
+    auto state = std::make_shared<BatchesState>();
+    state->count = count;
+    state->batchSize = std::max((size_t)1, batchSize);
+    state->batchCount = (count + state->batchSize - 1) / state->batchSize;
+    state->func = func;
+
+    // helpers which only start after we returned won't find any batches left
+    size_t helperCount = std::min(state->batchCount - 1, (size_t)workerPool.size());
+    for (size_t i = 0; i < helperCount; i++) {
+        workerPool.push([state](int threadId) {
+            while (state->RunNextBatch()) {
+            }
+        });
+    }
+
+    while (state->RunNextBatch()) {
+    }
+    while (state->inProgress != 0) {
+        std::this_thread::yield();
+    }
+}
+
 bool CBLSWorker::GenerateContributions(int quorumThreshold, const BLSIdVector& ids, BLSVerificationVectorPtr& vvecRet, BLSSecretKeyVector& skShares)
 {
     BLSSecretKeyVectorPtr svec = std::make_shared<BLSSecretKeyVector>((size_t)quorumThreshold);
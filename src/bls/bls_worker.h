@@ -56,6 +56,11 @@ public:
     void Start();
     void Stop();
 
+    // Runs func(start, count) for all batches of [0, count), on the worker threads and the calling thread. Batches
+    // are claimed by whichever thread is free first and only batches which already started are waited for, so this
+    // can't deadlock when all workers are busy
+    void ParallelForBatches(size_t count, size_t batchSize, const std::function<void(size_t, size_t)>& func);
+
     bool GenerateContributions(int threshold, const BLSIdVector& ids, BLSVerificationVectorPtr& vvecRet, BLSSecretKeyVector& skShares);
 
     // The following functions are all used to aggregate verification (public key) vectors
@@ -179,6 +184,12 @@ public:
             return worker.BuildPubKeyShare(vvec, id);
         });
     }
+    // Same as above, but lets the caller provide the share, e.g. by reading it from disk before building it
+    template <typename Builder>
+    CBLSPublicKey GetOrBuildPubKeyShare(const uint256& cacheKey, Builder&& builder)
+    {
+        return GetOrBuild(cacheKey, publicKeyShareCache, builder);
+    }
 
 private:
     template <typename T, typename Builder>
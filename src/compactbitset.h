@@ -0,0 +1,210 @@
+// Copyright (c) 2020 The BeeGroup developers are EternityGroup
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BEENODE_COMPACTBITSET_H
+#define BEENODE_COMPACTBITSET_H
+
+#include "serialize.h"
+
+#include <array>
+#include <stdexcept>
+#include <stdint.h>
+
+/**
+ * A bitset with a dynamic size up to a fixed capacity, stored inline as an array of 64 bit words.
+ *
+ * This is meant to replace std::vector<bool> for LLMQ member bitsets (inventories, valid members, signers...), which
+ * are never larger than the largest LLMQ. It does not allocate, and counting/merging works on whole words instead of
+ * single bits. Bits beyond size() are always kept at zero.
+ *
+ * It can be used with the same DYNBITSET/AUTOBITSET/... serialization wrappers as std::vector<bool> and results in the
+ * same serialized data.
+ */
+class CCompactBitSet
+{
+public:
+    static const size_t MAX_SIZE = 512;
+
+private:
+    static const size_t WORD_BITS = 64;
+    static const size_t WORD_COUNT = MAX_SIZE / WORD_BITS;
+
+    std::array<uint64_t, WORD_COUNT> words{};
+    uint16_t bitCount{0};
+
+public:
+    class reference
+    {
+    private:
+        uint64_t& word;
+        uint64_t mask;
+
+    public:
+        reference(uint64_t& _word, uint64_t _mask) : word(_word), mask(_mask) {}
+
+        operator bool() const { return (word & mask) != 0; }
+        reference& operator=(bool v)
+        {
+            if (v) {
+                word |= mask;
+            } else {
+                word &= ~mask;
+            }
+            return *this;
+        }
+        reference& operator=(const reference& r) { return *this = (bool)r; }
+    };
+
+public:
+    CCompactBitSet() {}
+    explicit CCompactBitSet(size_t size, bool v = false) { assign(size, v); }
+
+    size_t size() const { return bitCount; }
+    bool empty() const { return bitCount == 0; }
+
+    void resize(size_t size, bool v = false)
+    {
+        if (size > MAX_SIZE) {
+            throw std::length_error("CCompactBitSet::resize: size exceeds capacity");
+        }
+        size_t oldSize = bitCount;
+        bitCount = (uint16_t)size;
+        if (size < oldSize) {
+            ClearUnused();
+        } else if (v) {
+            for (size_t i = oldSize; i < size; i++) {
+                set(i);
+            }
+        }
+    }
+
+    void assign(size_t size, bool v)
+    {
+        if (size > MAX_SIZE) {
+            throw std::length_error("CCompactBitSet::assign: size exceeds capacity");
+        }
+        bitCount = (uint16_t)size;
+        SetAll(v);
+    }
+
+    bool operator[](size_t i) const { return (words[i / WORD_BITS] >> (i % WORD_BITS)) & 1; }
+    reference operator[](size_t i) { return reference(words[i / WORD_BITS], (uint64_t)1 << (i % WORD_BITS)); }
+
+    void set(size_t i, bool v = true) { (*this)[i] = v; }
+
+    void SetAll(bool v)
+    {
+        words.fill(v ? ~(uint64_t)0 : 0);
+        ClearUnused();
+    }
+
+    size_t count() const
+    {
+        size_t c = 0;
+        for (size_t i = 0; i < UsedWords(); i++) {
+            c += __builtin_popcountll(words[i]);
+        }
+        return c;
+    }
+
+    bool any() const
+    {
+        for (size_t i = 0; i < UsedWords(); i++) {
+            if (words[i]) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Both bitsets must have the same size. The loops work on whole words and are vectorized by the compiler
+    CCompactBitSet& operator|=(const CCompactBitSet& b)
+    {
+        assert(bitCount == b.bitCount);
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            words[i] |= b.words[i];
+        }
+        return *this;
+    }
+
+    CCompactBitSet& operator&=(const CCompactBitSet& b)
+    {
+        assert(bitCount == b.bitCount);
+        for (size_t i = 0; i < WORD_COUNT; i++) {
+            words[i] &= b.words[i];
+        }
+        return *this;
+    }
+
+    bool operator==(const CCompactBitSet& b) const { return bitCount == b.bitCount && words == b.words; }
+    bool operator!=(const CCompactBitSet& b) const { return !(*this == b); }
+    bool operator<(const CCompactBitSet& b) const
+    {
+        return bitCount < b.bitCount || (bitCount == b.bitCount && words < b.words);
+    }
+
+    template<typename Stream>
+    void SerializeFixed(Stream& s, size_t size) const
+    {
+        // on little endian systems, the words are already laid out like the serialized bytes
+        std::array<uint64_t, WORD_COUNT> le;
+        size_t wordCount = (size + WORD_BITS - 1) / WORD_BITS;
+        for (size_t i = 0; i < wordCount; i++) {
+            le[i] = htole64(words[i]);
+        }
+        s.write((const char*)le.data(), (size + 7) / 8);
+    }
+
+    template<typename Stream>
+    void UnserializeFixed(Stream& s, size_t size)
+    {
+        if (size > MAX_SIZE) {
+            throw std::ios_base::failure("CCompactBitSet size exceeds capacity");
+        }
+        bitCount = (uint16_t)size;
+        words.fill(0);
+        s.read((char*)words.data(), (size + 7) / 8);
+        for (size_t i = 0; i < UsedWords(); i++) {
+            words[i] = le64toh(words[i]);
+        }
+        if (size % WORD_BITS != 0 && (words[size / WORD_BITS] >> (size % WORD_BITS)) != 0) {
+            throw std::ios_base::failure("Out-of-range bits set");
+        }
+    }
+
+private:
+    size_t UsedWords() const { return (bitCount + WORD_BITS - 1) / WORD_BITS; }
+
+    void ClearUnused()
+    {
+        size_t i = bitCount / WORD_BITS;
+        if (i < WORD_COUNT) {
+            words[i] &= ((uint64_t)1 << (bitCount % WORD_BITS)) - 1;
+            for (i++; i < WORD_COUNT; i++) {
+                words[i] = 0;
+            }
+        }
+    }
+};
+
+template<typename Stream>
+void SerializeFixedBitSet(Stream& s, const CCompactBitSet& vec, size_t size)
+{
+    if (size <= vec.size()) {
+        vec.SerializeFixed(s, size);
+    } else {
+        // missing bits are serialized as zero
+        CCompactBitSet tmp = vec;
+        tmp.resize(size);
+        tmp.SerializeFixed(s, size);
+    }
+}
+
+template<typename Stream>
+void UnserializeFixedBitSet(Stream& s, CCompactBitSet& vec, size_t size)
+{
+    vec.UnserializeFixed(s, size);
+}
+
+#endif // BEENODE_COMPACTBITSET_H
@@ -704,6 +704,11 @@ public:
         return writes.empty() && deletes.empty();
     }
 
+    // Returns true if the key was written or erased in this transaction and the change is not committed yet
+    bool IsModified(const CDataStream& ssKey) const {
+        return writes.count(ssKey) || deletes.count(ssKey);
+    }
+
     size_t GetMemoryUsage() const {
         if (memoryUsage < 0) {
             // something went wrong when we accounted/calculated used memory...
@@ -12,6 +12,8 @@
 
 #include "chainparams.h"
 #include "consensus/merkle.h"
+#include "saltedhasher.h"
+#include "unordered_lru_cache.h"
 #include "univalue.h"
 #include "validation.h"
 
@@ -121,24 +123,24 @@ bool CalcCbTxMerkleRootMNList(const CBlock& block, const CBlockIndex* pindexPrev
     int64_t nTime3 = GetTimeMicros(); nTimeSMNL += nTime3 - nTime2;
     LogPrint("bench", "            - CSimplifiedMNList: %.2fms [%.2fs]\n", 0.001 * (nTime3 - nTime2), nTimeSMNL * 0.000001);
 
-    static CSimplifiedMNList smlCached;
-    static uint256 merkleRootCached;
-    static bool mutatedCached{false};
+    // Merkle trees of the lists calculated on top of recent blocks. Block templates and validation of blocks on top of
+    // the same or the next tip start from these trees, so that only changed entries need to be rehashed. Keeping
+    // multiple of them avoids recalculating everything when switching between tips, e.g. on reorgs.
+    static unordered_lru_cache<uint256, CSimplifiedMNListMerkleTree, StaticSaltedHasher, 8> smlTreeCache;
 
-    if (sml.mnList == smlCached.mnList) {
-        merkleRootRet = merkleRootCached;
-        return !mutatedCached;
+    CSimplifiedMNListMerkleTree smlTree;
+    if (!smlTreeCache.get(pindexPrev->GetBlockHash(), smlTree) && pindexPrev->pprev) {
+        smlTreeCache.get(pindexPrev->pprev->GetBlockHash(), smlTree);
     }
 
+    size_t nRehashed = smlTree.Update(sml);
     bool mutated = false;
-    merkleRootRet = sml.CalcMerkleRoot(&mutated);
+    merkleRootRet = smlTree.GetRoot(&mutated);
 
     int64_t nTime4 = GetTimeMicros(); nTimeMerkle += nTime4 - nTime3;
-    LogPrint("bench", "            - CalcMerkleRoot: %.2fms [%.2fs]\n", 0.001 * (nTime4 - nTime3), nTimeMerkle * 0.000001);
+    LogPrint("bench", "            - CalcMerkleRoot: %.2fms [%.2fs] (%d rehashed)\n", 0.001 * (nTime4 - nTime3), nTimeMerkle * 0.000001, nRehashed);
 
-    smlCached = std::move(sml);
-    merkleRootCached = merkleRootRet;
-    mutatedCached = mutated;
+    smlTreeCache.emplace(pindexPrev->GetBlockHash(), std::move(smlTree));
 
     return !mutated;
 }
@@ -8,12 +8,15 @@
 #include "base58.h"
 #include "chainparams.h"
 #include "core_io.h"
+#include "crypto/other/sha256.h"
 #include "script/standard.h"
 #include "ui_interface.h"
 #include "validation.h"
 #include "validationinterface.h"
 
+#include "bls/bls_worker.h"
 #include "llmq/quorums_commitment.h"
+#include "llmq/quorums_init.h"
 #include "llmq/quorums_utils.h"
 
 #include <univalue.h>
@@ -21,6 +24,10 @@
 static const std::string DB_LIST_SNAPSHOT = "dmn_S";
 static const std::string DB_LIST_DIFF = "dmn_D";
 
+// Lists with at least this many confirmed MNs have their scores calculated on the BLS worker threads
+static const size_t PARALLEL_SCORES_THRESHOLD = 2048;
+static const size_t PARALLEL_SCORES_BATCH_SIZE = 1024;
+
 CDeterministicMNManager* deterministicMNManager;
 
 std::string CDeterministicMNState::ToString() const
@@ -144,14 +151,13 @@ CDeterministicMNCPtr CDeterministicMNList::GetValidMN(const uint256& proTxHash)
     return dmn;
 }
 
-CDeterministicMNCPtr CDeterministicMNList::GetMNByOperatorKey(const CBLSPublicKey& pubKey)
+CDeterministicMNCPtr CDeterministicMNList::GetMNByOperatorKey(const CBLSPublicKey& pubKey) const
 {
-    for (const auto& p : mnMap) {
-        if (p.second->pdmnState->pubKeyOperator.Get() == pubKey) {
-            return p.second;
-        }
+    // operator keys are unique, so they are already indexed in mnUniquePropertyMap
+    if (!pubKey.IsValid()) {
+        return nullptr;
     }
-    return nullptr;
+    return GetUniquePropertyMN(pubKey);
 }
 
 CDeterministicMNCPtr CDeterministicMNList::GetMNByCollateral(const COutPoint& collateralOutpoint) const
@@ -191,6 +197,16 @@ CDeterministicMNCPtr CDeterministicMNList::GetMNByInternalId(uint64_t internalId
     return GetMN(*proTxHash);
 }
 
+std::vector<CDeterministicMNCPtr> CDeterministicMNList::GetMNsByPayoutScript(const CScript& scriptPayout) const
+{
+    return GetIndexedPropertyMNs(mnPayoutScriptIndex, scriptPayout);
+}
+
+std::vector<CDeterministicMNCPtr> CDeterministicMNList::GetMNsByVotingKey(const CKeyID& keyIDVoting) const
+{
+    return GetIndexedPropertyMNs(mnVotingKeyIndex, keyIDVoting);
+}
+
 static int CompareByLastPaid_GetHeight(const CDeterministicMN& dmn)
 {
     int height = dmn.pdmnState->nLastPaidHeight;
@@ -258,18 +274,25 @@ std::vector<CDeterministicMNCPtr> CDeterministicMNList::CalculateQuorum(size_t m
 {
     auto scores = CalculateScores(modifier);
 
-    // sort is descending order
-    std::sort(scores.rbegin(), scores.rend(), [](const std::pair<arith_uint256, CDeterministicMNCPtr>& a, std::pair<arith_uint256, CDeterministicMNCPtr>& b) {
+    // descending order
+    auto cmp = [](const std::pair<arith_uint256, CDeterministicMNCPtr>& a, const std::pair<arith_uint256, CDeterministicMNCPtr>& b) {
         if (a.first == b.first) {
             // this should actually never happen, but we should stay compatible with how the non deterministic MNs did the sorting
-            return a.second->collateralOutpoint < b.second->collateralOutpoint;
+            return b.second->collateralOutpoint < a.second->collateralOutpoint;
         }
-        return a.first < b.first;
-    });
+        return b.first < a.first;
+    };
+
+    // only the top maxSize entries need to be in order, so select them first and sort just those
+    size_t resultSize = std::min(maxSize, scores.size());
+    if (resultSize < scores.size()) {
+        std::nth_element(scores.begin(), scores.begin() + resultSize, scores.end(), cmp);
+    }
+    std::sort(scores.begin(), scores.begin() + resultSize, cmp);
 
     // take top maxSize entries and return it
     std::vector<CDeterministicMNCPtr> result;
-    result.resize(std::min(maxSize, scores.size()));
+    result.resize(resultSize);
     for (size_t i = 0; i < result.size(); i++) {
         result[i] = std::move(scores[i].second);
     }
@@ -278,27 +301,43 @@ std::vector<CDeterministicMNCPtr> CDeterministicMNList::CalculateQuorum(size_t m
 
 std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> CDeterministicMNList::CalculateScores(const uint256& modifier) const
 {
-    std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> scores;
-    scores.reserve(GetAllMNsCount());
+    std::vector<CDeterministicMNCPtr> confirmedMNs;
+    confirmedMNs.reserve(GetAllMNsCount());
     ForEachMN(true, [&](const CDeterministicMNCPtr& dmn) {
         if (dmn->pdmnState->confirmedHash.IsNull()) {
             // we only take confirmed MNs into account to avoid hash grinding on the ProRegTxHash to sneak MNs into a
             // future quorums
             return;
         }
-        // calculate sha256(sha256(proTxHash, confirmedHash), modifier) per MN
-        // Please note that this is not a double-sha256 but a single-sha256
-        // The first part is already precalculated (confirmedHashWithProRegTxHash)
-        // TODO When https://github.com/bitcoin/bitcoin/pull/13191 gets backported, implement something that is similar but for single-sha256
-        uint256 h;
-        CSHA256 sha256;
-        sha256.Write(dmn->pdmnState->confirmedHashWithProRegTxHash.begin(), dmn->pdmnState->confirmedHashWithProRegTxHash.size());
-        sha256.Write(modifier.begin(), modifier.size());
-        sha256.Finalize(h.begin());
-
-        scores.emplace_back(UintToArith256(h), dmn);
+        confirmedMNs.emplace_back(dmn);
     });
 
+    // calculate sha256(sha256(proTxHash, confirmedHash), modifier) per MN
+    // Please note that this is not a double-sha256 but a single-sha256
+    // The first part is already precalculated (confirmedHashWithProRegTxHash), so every score is the hash of a single
+    // 64 byte block, which allows us to hash multiple MNs per pass with SHA256S64
+    std::vector<unsigned char> input(confirmedMNs.size() * 64);
+    for (size_t i = 0; i < confirmedMNs.size(); i++) {
+        const uint256& h = confirmedMNs[i]->pdmnState->confirmedHashWithProRegTxHash;
+        memcpy(&input[i * 64], h.begin(), 32);
+        memcpy(&input[i * 64 + 32], modifier.begin(), 32);
+    }
+
+    std::vector<uint256> hashes(confirmedMNs.size());
+    auto hashBatch = [&](size_t start, size_t count) {
+        SHA256S64(hashes[start].begin(), &input[start * 64], count);
+    };
+    if (confirmedMNs.size() >= PARALLEL_SCORES_THRESHOLD && llmq::blsWorker) {
+        llmq::blsWorker->ParallelForBatches(confirmedMNs.size(), PARALLEL_SCORES_BATCH_SIZE, hashBatch);
+    } else {
+        hashBatch(0, confirmedMNs.size());
+    }
+
+    std::vector<std::pair<arith_uint256, CDeterministicMNCPtr>> scores;
+    scores.reserve(confirmedMNs.size());
+    for (size_t i = 0; i < confirmedMNs.size(); i++) {
+        scores.emplace_back(UintToArith256(hashes[i]), std::move(confirmedMNs[i]));
+    }
     return scores;
 }
 
@@ -451,6 +490,8 @@ void CDeterministicMNList::AddMN(const CDeterministicMNCPtr& dmn)
     if (dmn->pdmnState->pubKeyOperator.Get().IsValid()) {
         AddUniqueProperty(dmn, dmn->pdmnState->pubKeyOperator);
     }
+    AddIndexedProperty(mnPayoutScriptIndex, dmn, dmn->pdmnState->scriptPayout);
+    AddIndexedProperty(mnVotingKeyIndex, dmn, dmn->pdmnState->keyIDVoting);
 }
 
 void CDeterministicMNList::UpdateMN(const CDeterministicMNCPtr& oldDmn, const CDeterministicMNStateCPtr& pdmnState)
@@ -464,6 +505,8 @@ void CDeterministicMNList::UpdateMN(const CDeterministicMNCPtr& oldDmn, const CD
     UpdateUniqueProperty(dmn, oldState->addr, pdmnState->addr);
     UpdateUniqueProperty(dmn, oldState->keyIDOwner, pdmnState->keyIDOwner);
     UpdateUniqueProperty(dmn, oldState->pubKeyOperator, pdmnState->pubKeyOperator);
+    UpdateIndexedProperty(mnPayoutScriptIndex, dmn, oldState->scriptPayout, pdmnState->scriptPayout);
+    UpdateIndexedProperty(mnVotingKeyIndex, dmn, oldState->keyIDVoting, pdmnState->keyIDVoting);
 }
 
 void CDeterministicMNList::UpdateMN(const uint256& proTxHash, const CDeterministicMNStateCPtr& pdmnState)
@@ -494,12 +537,16 @@ void CDeterministicMNList::RemoveMN(const uint256& proTxHash)
     if (dmn->pdmnState->pubKeyOperator.Get().IsValid()) {
         DeleteUniqueProperty(dmn, dmn->pdmnState->pubKeyOperator);
     }
+    DeleteIndexedProperty(mnPayoutScriptIndex, dmn, dmn->pdmnState->scriptPayout);
+    DeleteIndexedProperty(mnVotingKeyIndex, dmn, dmn->pdmnState->keyIDVoting);
     mnMap = mnMap.erase(proTxHash);
     mnInternalIdMap = mnInternalIdMap.erase(dmn->internalId);
 }
 
-CDeterministicMNManager::CDeterministicMNManager(CEvoDB& _evoDb) :
-    evoDb(_evoDb)
+CDeterministicMNManager::CDeterministicMNManager(CEvoDB& _evoDb, int _nSnapshotPeriod, size_t _nMaxCacheMemoryUsage) :
+    evoDb(_evoDb),
+    nMaxCacheMemoryUsage(_nMaxCacheMemoryUsage),
+    nSnapshotPeriod(std::max(1, _nSnapshotPeriod))
 {
 }
 
@@ -539,7 +586,7 @@ bool CDeterministicMNManager::ProcessBlock(const CBlock& block, const CBlockInde
         diff = oldList.BuildDiff(newList);
 
         evoDb.Write(std::make_pair(DB_LIST_DIFF, newList.GetBlockHash()), diff);
-        if ((nHeight % SNAPSHOT_LIST_PERIOD) == 0 || oldList.GetHeight() == -1) {
+        if ((nHeight % nSnapshotPeriod) == 0 || oldList.GetHeight() == -1) {
             evoDb.Write(std::make_pair(DB_LIST_SNAPSHOT, newList.GetBlockHash()), newList);
             LogPrintf("CDeterministicMNManager::%s -- Wrote snapshot. nHeight=%d, mapCurMNs.allMNsCount=%d\n",
                 __func__, nHeight, newList.GetAllMNsCount());
@@ -588,7 +635,7 @@ bool CDeterministicMNManager::UndoBlock(const CBlock& block, const CBlockIndex*
         evoDb.Erase(std::make_pair(DB_LIST_DIFF, blockHash));
         evoDb.Erase(std::make_pair(DB_LIST_SNAPSHOT, blockHash));
 
-        mnListsCache.erase(blockHash);
+        EraseFromCache(blockHash);
     }
 
     if (diff.HasChanges()) {
@@ -892,46 +939,91 @@ CDeterministicMNList CDeterministicMNManager::GetListForBlock(const CBlockIndex*
 {
     LOCK(cs);
 
+    auto it = mnListsCache.find(pindex->GetBlockHash());
+    if (it != mnListsCache.end()) {
+        cacheStats.nHits++;
+        return it->second.mnList;
+    }
+    cacheStats.nMisses++;
+
+    // blocks below DIP3 activation never have diffs or snapshots
+    const int nDIP3Height = Params().GetConsensus().DIP0003Height;
+
     CDeterministicMNList snapshot;
-    std::list<std::pair<const CBlockIndex*, CDeterministicMNListDiff>> listDiff;
-
-    while (true) {
-        // try using cache before reading from disk
-        auto it = mnListsCache.find(pindex->GetBlockHash());
-        if (it != mnListsCache.end()) {
-            snapshot = it->second;
-            break;
+    std::vector<const CBlockIndex*> toReplay; // newest first
+    bool fHaveBase = false;
+    while (!fHaveBase) {
+        // collect blocks until we hit a cached list, but at most one snapshot period at a time so that we don't
+        // have to look for snapshots in more blocks than necessary
+        size_t nChunkStart = toReplay.size();
+        while (pindex && pindex->nHeight >= nDIP3Height && toReplay.size() - nChunkStart <= (size_t)nSnapshotPeriod) {
+            it = mnListsCache.find(pindex->GetBlockHash());
+            if (it != mnListsCache.end()) {
+                snapshot = it->second.mnList;
+                fHaveBase = true;
+                break;
+            }
+            toReplay.emplace_back(pindex);
+            pindex = pindex->pprev;
         }
 
-        if (evoDb.Read(std::make_pair(DB_LIST_SNAPSHOT, pindex->GetBlockHash()), snapshot)) {
-            mnListsCache.emplace(pindex->GetBlockHash(), snapshot);
-            break;
+        // a snapshot in the collected blocks is always closer than the cached list
+        std::vector<std::pair<std::string, uint256>> snapshotKeys;
+        snapshotKeys.reserve(toReplay.size() - nChunkStart);
+        for (size_t i = nChunkStart; i < toReplay.size(); i++) {
+            snapshotKeys.emplace_back(DB_LIST_SNAPSHOT, toReplay[i]->GetBlockHash());
         }
-
-        CDeterministicMNListDiff diff;
-        if (!evoDb.Read(std::make_pair(DB_LIST_DIFF, pindex->GetBlockHash()), diff)) {
-            snapshot = CDeterministicMNList(pindex->GetBlockHash(), -1, 0);
-            mnListsCache.emplace(pindex->GetBlockHash(), snapshot);
-            break;
+        std::map<std::pair<std::string, uint256>, CDeterministicMNList> snapshots;
+        if (evoDb.ReadMultiple(snapshotKeys, snapshots) != 0) {
+            for (size_t i = nChunkStart; i < toReplay.size(); i++) {
+                auto snapshotIt = snapshots.find(snapshotKeys[i - nChunkStart]);
+                if (snapshotIt != snapshots.end()) {
+                    snapshot = std::move(snapshotIt->second);
+                    AddToCache(toReplay[i]->GetBlockHash(), snapshot);
+                    toReplay.resize(i);
+                    fHaveBase = true;
+                    break;
+                }
+            }
         }
 
-        listDiff.emplace_front(pindex, std::move(diff));
-        pindex = pindex->pprev;
+        if (!fHaveBase && (!pindex || pindex->nHeight < nDIP3Height)) {
+            snapshot = CDeterministicMNList(pindex ? pindex->GetBlockHash() : uint256(), -1, 0);
+            if (pindex) {
+                AddToCache(pindex->GetBlockHash(), snapshot);
+            }
+            fHaveBase = true;
+        }
     }
 
-    for (const auto& p : listDiff) {
-        auto diffIndex = p.first;
-        auto& diff = p.second;
-        if (diff.HasChanges()) {
-            snapshot = snapshot.ApplyDiff(diffIndex, diff);
+    std::vector<std::pair<std::string, uint256>> diffKeys;
+    diffKeys.reserve(toReplay.size());
+    for (const auto& diffIndex : toReplay) {
+        diffKeys.emplace_back(DB_LIST_DIFF, diffIndex->GetBlockHash());
+    }
+    std::map<std::pair<std::string, uint256>, CDeterministicMNListDiff> diffs;
+    evoDb.ReadMultiple(diffKeys, diffs);
+
+    for (auto replayIt = toReplay.rbegin(); replayIt != toReplay.rend(); ++replayIt) {
+        auto diffIndex = *replayIt;
+        auto diffIt = diffs.find(std::make_pair(DB_LIST_DIFF, diffIndex->GetBlockHash()));
+        if (diffIt == diffs.end()) {
+            // no list was stored for this block
+            snapshot = CDeterministicMNList(diffIndex->GetBlockHash(), -1, 0);
+        } else if (diffIt->second.HasChanges()) {
+            snapshot = snapshot.ApplyDiff(diffIndex, diffIt->second);
         } else {
             snapshot.SetBlockHash(diffIndex->GetBlockHash());
             snapshot.SetHeight(diffIndex->nHeight);
         }
 
-        mnListsCache.emplace(diffIndex->GetBlockHash(), snapshot);
+        AddToCache(diffIndex->GetBlockHash(), snapshot);
     }
 
+    cacheStats.nReplayedDiffs += toReplay.size();
+    cacheStats.nLastReplayDepth = toReplay.size();
+    cacheStats.nMaxReplayDepth = std::max(cacheStats.nMaxReplayDepth, toReplay.size());
+
     return snapshot;
 }
 
@@ -977,18 +1069,64 @@ bool CDeterministicMNManager::IsDIP3Enforced(int nHeight)
     return nHeight >= Params().GetConsensus().DIP0003EnforcementHeight;
 }
 
-void CDeterministicMNManager::CleanupCache(int nHeight)
+CDeterministicMNListCacheStats CDeterministicMNManager::GetCacheStats()
+{
+    LOCK(cs);
+    CDeterministicMNListCacheStats stats = cacheStats;
+    stats.nEntries = mnListsCache.size();
+    stats.nMaxMemoryUsage = nMaxCacheMemoryUsage;
+    return stats;
+}
+
+// Upper bound of the memory used by a single cached list. Neighbouring lists share most of their nodes, so the real
+// memory usage of the cache is usually much lower.
+static size_t EstimateListMemoryUsage(const CDeterministicMNList& mnList)
+{
+    static const size_t nPerMN = sizeof(std::pair<uint256, CDeterministicMNCPtr>) + // mnMap
+                                 sizeof(std::pair<uint64_t, uint256>) + // mnInternalIdMap
+                                 4 * sizeof(std::pair<uint256, std::pair<uint256, uint32_t>>) + // mnUniquePropertyMap
+                                 2 * sizeof(std::pair<uint256, uint256>); // payout script and voting key indexes
+    return sizeof(CDeterministicMNList) + mnList.GetAllMNsCount() * nPerMN;
+}
+
+void CDeterministicMNManager::AddToCache(const uint256& blockHash, const CDeterministicMNList& mnList)
 {
     AssertLockHeld(cs);
 
-    std::vector<uint256> toDelete;
-    for (const auto& p : mnListsCache) {
-        if (p.second.GetHeight() + LISTS_CACHE_SIZE < nHeight) {
-            toDelete.emplace_back(p.first);
-        }
+    if (mnListsCache.count(blockHash)) {
+        return;
     }
-    for (const auto& h : toDelete) {
-        mnListsCache.erase(h);
+
+    size_t nMemoryUsage = EstimateListMemoryUsage(mnList);
+    auto heightIt = mnListsCacheByHeight.emplace(mnList.GetHeight(), blockHash);
+    mnListsCache.emplace(blockHash, CachedList{mnList, nMemoryUsage, heightIt});
+    cacheStats.nMemoryUsage += nMemoryUsage;
+
+    // evict the lowest lists first, these are the least likely to be needed again
+    while (cacheStats.nMemoryUsage > nMaxCacheMemoryUsage && mnListsCache.size() > 1) {
+        EraseFromCache(mnListsCacheByHeight.begin()->second);
+    }
+}
+
+void CDeterministicMNManager::EraseFromCache(const uint256& blockHash)
+{
+    AssertLockHeld(cs);
+
+    auto it = mnListsCache.find(blockHash);
+    if (it == mnListsCache.end()) {
+        return;
+    }
+    cacheStats.nMemoryUsage -= it->second.nMemoryUsage;
+    mnListsCacheByHeight.erase(it->second.heightIt);
+    mnListsCache.erase(it);
+}
+
+void CDeterministicMNManager::CleanupCache(int nHeight)
+{
+    AssertLockHeld(cs);
+
+    while (!mnListsCacheByHeight.empty() && mnListsCacheByHeight.begin()->first + LISTS_CACHE_SIZE < nHeight) {
+        EraseFromCache(mnListsCacheByHeight.begin()->second);
     }
 }
 
@@ -1083,7 +1221,7 @@ void CDeterministicMNManager::UpgradeDBIfNeeded()
         CDeterministicMNList newMNList;
         UpgradeDiff(batch, pindex, curMNList, newMNList);
 
-        if ((nHeight % SNAPSHOT_LIST_PERIOD) == 0) {
+        if ((nHeight % nSnapshotPeriod) == 0) {
             batch.Write(std::make_pair(DB_LIST_SNAPSHOT, pindex->GetBlockHash()), newMNList);
             evoDb.GetRawDB().WriteBatch(batch);
             batch.Clear();
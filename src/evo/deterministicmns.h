@@ -10,13 +10,16 @@
 #include "dbwrapper.h"
 #include "evodb.h"
 #include "providertx.h"
+#include "saltedhasher.h"
 #include "simplifiedmns.h"
 #include "sync.h"
 
 #include "immer/map.hpp"
 #include "immer/map_transient.hpp"
+#include "immer/set.hpp"
 
 #include <map>
+#include <unordered_map>
 
 class CBlock;
 class CBlockIndex;
@@ -276,6 +279,8 @@ public:
     typedef immer::map<uint256, CDeterministicMNCPtr> MnMap;
     typedef immer::map<uint64_t, uint256> MnInternalIdMap;
     typedef immer::map<uint256, std::pair<uint256, uint32_t> > MnUniquePropertyMap;
+    // maps the hash of a property which several MNs may share to the proTxHashes of these MNs
+    typedef immer::map<uint256, immer::set<uint256> > MnPropertyIndexMap;
 
 private:
     uint256 blockHash;
@@ -288,6 +293,10 @@ private:
     // we keep track of this as checking for duplicates would otherwise be painfully slow
     MnUniquePropertyMap mnUniquePropertyMap;
 
+    // secondary indexes for lookups by payee and voting key
+    MnPropertyIndexMap mnPayoutScriptIndex;
+    MnPropertyIndexMap mnVotingKeyIndex;
+
 public:
     CDeterministicMNList() {}
     explicit CDeterministicMNList(const uint256& _blockHash, int _height, uint32_t _totalRegisteredCount) :
@@ -321,6 +330,8 @@ public:
         mnMap = MnMap();
         mnUniquePropertyMap = MnUniquePropertyMap();
         mnInternalIdMap = MnInternalIdMap();
+        mnPayoutScriptIndex = MnPropertyIndexMap();
+        mnVotingKeyIndex = MnPropertyIndexMap();
 
         SerializationOpBase(s, CSerActionUnserialize());
 
@@ -406,12 +417,14 @@ public:
     }
     CDeterministicMNCPtr GetMN(const uint256& proTxHash) const;
     CDeterministicMNCPtr GetValidMN(const uint256& proTxHash) const;
-    CDeterministicMNCPtr GetMNByOperatorKey(const CBLSPublicKey& pubKey);
+    CDeterministicMNCPtr GetMNByOperatorKey(const CBLSPublicKey& pubKey) const;
     CDeterministicMNCPtr GetMNByCollateral(const COutPoint& collateralOutpoint) const;
     CDeterministicMNCPtr GetValidMNByCollateral(const COutPoint& collateralOutpoint) const;
     CDeterministicMNCPtr GetMNByService(const CService& service) const;
     CDeterministicMNCPtr GetValidMNByService(const CService& service) const;
     CDeterministicMNCPtr GetMNByInternalId(uint64_t internalId) const;
+    std::vector<CDeterministicMNCPtr> GetMNsByPayoutScript(const CScript& scriptPayout) const;
+    std::vector<CDeterministicMNCPtr> GetMNsByVotingKey(const CKeyID& keyIDVoting) const;
     CDeterministicMNCPtr GetMNPayee() const;
 
     /**
@@ -536,6 +549,60 @@ private:
             AddUniqueProperty(dmn, newValue);
         }
     }
+
+    template <typename T>
+    static void AddIndexedProperty(MnPropertyIndexMap& index, const CDeterministicMNCPtr& dmn, const T& v)
+    {
+        static const T nullValue;
+        if (v == nullValue) {
+            return;
+        }
+
+        auto hash = ::SerializeHash(v);
+        auto oldEntry = index.find(hash);
+        auto newEntry = oldEntry ? oldEntry->insert(dmn->proTxHash) : immer::set<uint256>().insert(dmn->proTxHash);
+        index = index.set(hash, newEntry);
+    }
+    template <typename T>
+    static void DeleteIndexedProperty(MnPropertyIndexMap& index, const CDeterministicMNCPtr& dmn, const T& oldValue)
+    {
+        static const T nullValue;
+        if (oldValue == nullValue) {
+            return;
+        }
+
+        auto oldHash = ::SerializeHash(oldValue);
+        auto p = index.find(oldHash);
+        assert(p && p->count(dmn->proTxHash));
+        auto newEntry = p->erase(dmn->proTxHash);
+        if (newEntry.size() == 0) {
+            index = index.erase(oldHash);
+        } else {
+            index = index.set(oldHash, newEntry);
+        }
+    }
+    template <typename T>
+    static void UpdateIndexedProperty(MnPropertyIndexMap& index, const CDeterministicMNCPtr& dmn, const T& oldValue, const T& newValue)
+    {
+        if (oldValue == newValue) {
+            return;
+        }
+        DeleteIndexedProperty(index, dmn, oldValue);
+        AddIndexedProperty(index, dmn, newValue);
+    }
+    template <typename T>
+    std::vector<CDeterministicMNCPtr> GetIndexedPropertyMNs(const MnPropertyIndexMap& index, const T& v) const
+    {
+        std::vector<CDeterministicMNCPtr> result;
+        auto p = index.find(::SerializeHash(v));
+        if (p) {
+            result.reserve(p->size());
+            for (const auto& proTxHash : *p) {
+                result.emplace_back(GetMN(proTxHash));
+            }
+        }
+        return result;
+    }
 };
 
 class CDeterministicMNListDiff
@@ -623,9 +690,23 @@ public:
     }
 };
 
+struct CDeterministicMNListCacheStats
+{
+    size_t nEntries{0};
+    size_t nMemoryUsage{0};
+    size_t nMaxMemoryUsage{0};
+    uint64_t nHits{0};
+    uint64_t nMisses{0};
+    uint64_t nReplayedDiffs{0};
+    size_t nLastReplayDepth{0};
+    size_t nMaxReplayDepth{0};
+};
+
+static const int DEFAULT_MNLIST_SNAPSHOT_PERIOD = 576; // once per day
+static const int64_t DEFAULT_MNLIST_CACHE_SIZE = 256; // MiB
+
 class CDeterministicMNManager
 {
-    static const int SNAPSHOT_LIST_PERIOD = 576; // once per day
     static const int LISTS_CACHE_SIZE = 576;
 
 public:
@@ -634,11 +715,22 @@ public:
 private:
     CEvoDB& evoDb;
 
-    std::map<uint256, CDeterministicMNList> mnListsCache;
+    // lists are kept ordered by height, so that the lowest ones can be evicted first
+    struct CachedList {
+        CDeterministicMNList mnList;
+        size_t nMemoryUsage;
+        std::multimap<int, uint256>::iterator heightIt;
+    };
+    std::unordered_map<uint256, CachedList, StaticSaltedHasher> mnListsCache;
+    std::multimap<int, uint256> mnListsCacheByHeight;
+    size_t nMaxCacheMemoryUsage;
+    CDeterministicMNListCacheStats cacheStats;
+
+    int nSnapshotPeriod;
     const CBlockIndex* tipIndex{nullptr};
 
 public:
-    CDeterministicMNManager(CEvoDB& _evoDb);
+    CDeterministicMNManager(CEvoDB& _evoDb, int _nSnapshotPeriod = DEFAULT_MNLIST_SNAPSHOT_PERIOD, size_t _nMaxCacheMemoryUsage = DEFAULT_MNLIST_CACHE_SIZE << 20);
 
     bool ProcessBlock(const CBlock& block, const CBlockIndex* pindex, CValidationState& state, bool fJustCheck);
     bool UndoBlock(const CBlock& block, const CBlockIndex* pindex);
@@ -658,12 +750,16 @@ public:
 
     bool IsDIP3Enforced(int nHeight = -1);
 
+    CDeterministicMNListCacheStats GetCacheStats();
+
 public:
     // TODO these can all be removed in a future version
     bool UpgradeDiff(CDBBatch& batch, const CBlockIndex* pindexNext, const CDeterministicMNList& curMNList, CDeterministicMNList& newMNList);
     void UpgradeDBIfNeeded();
 
 private:
+    void AddToCache(const uint256& blockHash, const CDeterministicMNList& mnList);
+    void EraseFromCache(const uint256& blockHash);
     void CleanupCache(int nHeight);
 };
 
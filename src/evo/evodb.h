@@ -56,6 +56,56 @@ public:
         curDBTransaction.Write(key, value);
     }
 
+    // Reads many keys at once and returns the number of keys found. Keys which were not modified in the current
+    // transactions are read from the DB with a single iterator, visiting them in key order. This is much cheaper than
+    // calling Read() for each of them when replaying long chains of diffs.
+    template <typename K, typename V>
+    size_t ReadMultiple(const std::vector<K>& keys, std::map<K, V>& valuesRet)
+    {
+        LOCK(cs);
+
+        size_t found = 0;
+        std::vector<std::pair<CDataStream, const K*>> dbKeys;
+        dbKeys.reserve(keys.size());
+        for (const auto& key : keys) {
+            CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+            ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
+            ssKey << key;
+            if (curDBTransaction.IsModified(ssKey) || rootDBTransaction.IsModified(ssKey)) {
+                V value;
+                if (curDBTransaction.Read(ssKey, value)) {
+                    valuesRet[key] = std::move(value);
+                    found++;
+                }
+            } else {
+                dbKeys.emplace_back(std::move(ssKey), &key);
+            }
+        }
+
+        std::sort(dbKeys.begin(), dbKeys.end(), [](const std::pair<CDataStream, const K*>& a, const std::pair<CDataStream, const K*>& b) {
+            return std::lexicographical_compare(a.first.begin(), a.first.end(), b.first.begin(), b.first.end(),
+                                                [](char c1, char c2) { return (uint8_t)c1 < (uint8_t)c2; });
+        });
+
+        std::unique_ptr<CDBIterator> it(db.NewIterator());
+        for (const auto& p : dbKeys) {
+            it->Seek(p.first);
+            if (!it->Valid() || it->GetKeySize() != p.first.size()) {
+                continue;
+            }
+            CDataStream ssKey = it->GetKey();
+            if (!std::equal(ssKey.begin(), ssKey.end(), p.first.begin())) {
+                continue;
+            }
+            V value;
+            if (it->GetValue(value)) {
+                valuesRet[*p.second] = std::move(value);
+                found++;
+            }
+        }
+        return found;
+    }
+
     template <typename K>
     bool Exists(const K& key)
     {
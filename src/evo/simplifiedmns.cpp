@@ -14,6 +14,7 @@
 #include "base58.h"
 #include "chainparams.h"
 #include "consensus/merkle.h"
+#include "crypto/other/sha256.h"
 #include "univalue.h"
 #include "validation.h"
 
@@ -88,6 +89,118 @@ uint256 CSimplifiedMNList::CalcMerkleRoot(bool* pmutated) const
     return ComputeMerkleRoot(leaves, pmutated);
 }
 
+size_t CSimplifiedMNListMerkleTree::Update(const CSimplifiedMNList& sml)
+{
+    // both lists are sorted by proRegTxHash, so unchanged entries can be found in a single pass
+    std::vector<std::shared_ptr<const CSimplifiedMNListEntry>> newEntries;
+    std::vector<uint256> newLeaves;
+    newEntries.reserve(sml.mnList.size());
+    newLeaves.reserve(sml.mnList.size());
+    size_t nRehashed = 0;
+    size_t oldPos = 0;
+    for (const auto& e : sml.mnList) {
+        while (oldPos < entries.size() && entries[oldPos]->proRegTxHash < e->proRegTxHash) {
+            oldPos++;
+        }
+        if (oldPos < entries.size() && *entries[oldPos] == *e) {
+            newEntries.emplace_back(entries[oldPos]);
+            newLeaves.emplace_back(levels[0][oldPos]);
+        } else {
+            newEntries.emplace_back(std::make_shared<CSimplifiedMNListEntry>(*e));
+            newLeaves.emplace_back(e->CalcHash());
+            nRehashed++;
+        }
+    }
+
+    std::vector<size_t> dirty;
+    for (size_t i = 0; i < newLeaves.size(); i++) {
+        if (i >= levels[0].size() || newLeaves[i] != levels[0][i]) {
+            dirty.emplace_back(i);
+        }
+    }
+    bool fResized = newLeaves.size() != levels[0].size();
+    entries = std::move(newEntries);
+    levels[0] = std::move(newLeaves);
+
+    // Recompute the parents of all changed nodes, one level at a time. When the size of a level changed, the last
+    // parent must be recomputed as well, as its last child might have been duplicated or not before.
+    size_t level = 0;
+    std::vector<uint256> buf;
+    for (; levels[level].size() > 1; level++) {
+        if (dirty.empty() && !fResized) {
+            // nothing changed from here on
+            return nRehashed;
+        }
+        if (levels.size() == level + 1) {
+            levels.emplace_back();
+        }
+        if (identicalPairs.size() == level) {
+            identicalPairs.emplace_back();
+        }
+        const auto& cur = levels[level];
+        auto& parent = levels[level + 1];
+        auto& identical = identicalPairs[level];
+
+        size_t parentSize = (cur.size() + 1) / 2;
+        std::vector<size_t> parentDirty;
+        for (size_t i : dirty) {
+            if (parentDirty.empty() || parentDirty.back() != i / 2) {
+                parentDirty.emplace_back(i / 2);
+            }
+        }
+        if (fResized && (parentDirty.empty() || parentDirty.back() != parentSize - 1)) {
+            parentDirty.emplace_back(parentSize - 1);
+        }
+
+        size_t oldParentSize = parent.size();
+        fResized = parentSize != oldParentSize;
+        parent.resize(parentSize);
+        identical.erase(identical.lower_bound(parentSize), identical.end());
+
+        buf.resize(parentDirty.size() * 2);
+        for (size_t i = 0; i < parentDirty.size(); i++) {
+            size_t left = parentDirty[i] * 2;
+            bool fHasRight = left + 1 < cur.size();
+            buf[i * 2] = cur[left];
+            buf[i * 2 + 1] = fHasRight ? cur[left + 1] : cur[left];
+            if (fHasRight && cur[left] == cur[left + 1]) {
+                identical.emplace(parentDirty[i]);
+            } else {
+                identical.erase(parentDirty[i]);
+            }
+        }
+        SHA256D64(buf[0].begin(), buf[0].begin(), parentDirty.size());
+
+        dirty.clear();
+        for (size_t i = 0; i < parentDirty.size(); i++) {
+            size_t pos = parentDirty[i];
+            if (pos >= oldParentSize || parent[pos] != buf[i]) {
+                parent[pos] = buf[i];
+                dirty.emplace_back(pos);
+            }
+        }
+    }
+
+    // drop the levels above the root in case the tree got lower
+    levels.resize(level + 1);
+    identicalPairs.resize(level);
+
+    return nRehashed;
+}
+
+uint256 CSimplifiedMNListMerkleTree::GetRoot(bool* pmutated) const
+{
+    if (pmutated) {
+        *pmutated = std::any_of(identicalPairs.begin(), identicalPairs.end(), [](const std::set<size_t>& s) {
+            return !s.empty();
+        });
+    }
+    if (levels.back().empty()) {
+        return uint256();
+    }
+    return levels.back()[0];
+}
+
 CSimplifiedMNListDiff::CSimplifiedMNListDiff()
 {
 }
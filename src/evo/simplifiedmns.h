@@ -12,7 +12,11 @@
 #include "serialize.h"
 #include "version.h"
 
+#include <memory>
+#include <set>
+
 class UniValue;
+class CBlockIndex;
 class CDeterministicMNList;
 class CDeterministicMN;
 
@@ -84,6 +88,24 @@ public:
     uint256 CalcMerkleRoot(bool* pmutated = NULL) const;
 };
 
+// Merkle tree over the entries of a CSimplifiedMNList. Updating it to a new list only rehashes the entries which
+// changed and the paths from them to the root. The resulting root is the same as CSimplifiedMNList::CalcMerkleRoot
+class CSimplifiedMNListMerkleTree
+{
+private:
+    // sorted by proRegTxHash, same as in CSimplifiedMNList. Entries are shared between copies of the tree
+    std::vector<std::shared_ptr<const CSimplifiedMNListEntry>> entries;
+    // levels[0] contains the hashes of the entries, levels.back() the root
+    std::vector<std::vector<uint256>> levels{1};
+    // per level, the indexes of pairs with two identical hashes (see ComputeMerkleRoot)
+    std::vector<std::set<size_t>> identicalPairs;
+
+public:
+    // Returns the number of entries which had to be rehashed
+    size_t Update(const CSimplifiedMNList& sml);
+    uint256 GetRoot(bool* pmutated = nullptr) const;
+};
+
 /// P2P messages
 
 class CGetSimplifiedMNListDiff
@@ -7,6 +7,14 @@
 #include "crypto/other/hmac_sha512.h"
 #include "pubkey.h"
 
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 
 inline uint32_t ROTL32(uint32_t x, int8_t r)
 {
@@ -249,3 +257,181 @@ uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint3
     SIPROUND;
     return v0 ^ v1 ^ v2 ^ v3;
 }
+
+void HoneyCombXorLanes(unsigned char* out, const unsigned char* a, const unsigned char* b, const unsigned char* c)
+{
+#if defined(__AVX2__)
+    for (size_t i = 0; i < CHoneyCombHasher::LANE_SIZE; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(a + i));
+        x = _mm256_xor_si256(x, _mm256_loadu_si256((const __m256i*)(b + i)));
+        x = _mm256_xor_si256(x, _mm256_loadu_si256((const __m256i*)(c + i)));
+        _mm256_storeu_si256((__m256i*)(out + i), x);
+    }
+#elif defined(__SSE2__)
+    for (size_t i = 0; i < CHoneyCombHasher::LANE_SIZE; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(a + i));
+        x = _mm_xor_si128(x, _mm_loadu_si128((const __m128i*)(b + i)));
+        x = _mm_xor_si128(x, _mm_loadu_si128((const __m128i*)(c + i)));
+        _mm_storeu_si128((__m128i*)(out + i), x);
+    }
+#else
+    for (size_t i = 0; i < CHoneyCombHasher::LANE_SIZE; i += 8) {
+        uint64_t x, y, z;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        memcpy(&z, c + i, 8);
+        x ^= y ^ z;
+        memcpy(out + i, &x, 8);
+    }
+#endif
+}
+
+namespace {
+
+/** Facet contexts right after their *_init(), copied into every (re)initialized hasher. */
+struct PristineHoneyCombContexts
+{
+    CHoneyCombHasher::FacetContexts ctx;
+
+    PristineHoneyCombContexts()
+    {
+        facet_one_init(&ctx.one);
+        facet_four_init(&ctx.four);
+        facet_five_init(&ctx.five);
+        facet_six_init(&ctx.six);
+        facet_two_init(&ctx.two);
+        facet_three_init(&ctx.three);
+    }
+};
+
+const CHoneyCombHasher::FacetContexts& GetPristineHoneyCombContexts()
+{
+    static const PristineHoneyCombContexts pristine;
+    return pristine.ctx;
+}
+
+} // namespace
+
+CHoneyCombHasher::CHoneyCombHasher()
+{
+    Reset();
+}
+
+CHoneyCombHasher& CHoneyCombHasher::Reset()
+{
+    memcpy(&ctx, &GetPristineHoneyCombContexts(), sizeof(ctx));
+    memset(head, 0, sizeof(head));
+    memset(tail, 0, sizeof(tail));
+    bytes = 0;
+    return *this;
+}
+
+CHoneyCombHasher& CHoneyCombHasher::Write(const unsigned char* data, size_t len)
+{
+    if (len == 0) {
+        return *this;
+    }
+
+    facet_one(&ctx.one, data, len);
+    facet_four(&ctx.four, data, len);
+    facet_five(&ctx.five, data, len);
+    facet_six(&ctx.six, data, len);
+
+    // Keep the first HONEY_HEAD and the last HONEY_TAIL bytes for the honey lane
+    if (bytes < HONEY_HEAD) {
+        size_t n = std::min<size_t>(HONEY_HEAD - bytes, len);
+        memcpy(head + bytes, data, n);
+    }
+    if (len >= HONEY_TAIL) {
+        memcpy(tail, data + len - HONEY_TAIL, HONEY_TAIL);
+    } else {
+        memmove(tail, tail + len, HONEY_TAIL - len);
+        memcpy(tail + HONEY_TAIL - len, data, len);
+    }
+    bytes += len;
+    return *this;
+}
+
+void CHoneyCombHasher::Finalize(unsigned char hash[OUTPUT_SIZE])
+{
+    alignas(32) unsigned char honey[LANE_SIZE];
+    alignas(32) unsigned char a[LANE_SIZE];
+    alignas(32) unsigned char b[LANE_SIZE];
+
+    memcpy(honey, head, HONEY_HEAD);
+    memcpy(honey + HONEY_HEAD, tail, HONEY_TAIL);
+
+    facet_one_close(&ctx.one, a);
+    facet_four_close(&ctx.four, b);
+    HoneyCombXorLanes(a, a, b, honey);
+    facet_two(&ctx.two, a, LANE_SIZE);
+    facet_two_close(&ctx.two, a);
+
+    facet_five_close(&ctx.five, b);
+    HoneyCombXorLanes(a, a, b, honey);
+    facet_three(&ctx.three, a, LANE_SIZE);
+    facet_three_close(&ctx.three, a);
+
+    facet_six_close(&ctx.six, b);
+    HoneyCombXorLanes(a, a, b, honey);
+    memcpy(hash, a, OUTPUT_SIZE);
+}
+
+void HashHoneyComb80Batch(const unsigned char* in, size_t n, unsigned char* out)
+{
+    static const size_t INPUT_SIZE = 80;
+    static const size_t LANE_SIZE = CHoneyCombHasher::LANE_SIZE;
+
+    const CHoneyCombHasher::FacetContexts& pristine = GetPristineHoneyCombContexts();
+    CHoneyCombHasher::FacetContexts ctx;
+
+    alignas(32) unsigned char honey[HONEYCOMB_BATCH_LANES][LANE_SIZE];
+    alignas(32) unsigned char a[HONEYCOMB_BATCH_LANES][LANE_SIZE];
+    alignas(32) unsigned char b[HONEYCOMB_BATCH_LANES][LANE_SIZE];
+
+    for (size_t pos = 0; pos < n; pos += HONEYCOMB_BATCH_LANES) {
+        const size_t lanes = std::min(HONEYCOMB_BATCH_LANES, n - pos);
+        const unsigned char* group = in + pos * INPUT_SIZE;
+
+        for (size_t i = 0; i < lanes; i++) {
+            const unsigned char* p = group + i * INPUT_SIZE;
+            memcpy(honey[i], p, CHoneyCombHasher::HONEY_HEAD);
+            memcpy(honey[i] + CHoneyCombHasher::HONEY_HEAD, p + INPUT_SIZE - CHoneyCombHasher::HONEY_TAIL, CHoneyCombHasher::HONEY_TAIL);
+        }
+
+        for (size_t i = 0; i < lanes; i++) {
+            ctx.one = pristine.one;
+            facet_one(&ctx.one, group + i * INPUT_SIZE, INPUT_SIZE);
+            facet_one_close(&ctx.one, a[i]);
+        }
+        for (size_t i = 0; i < lanes; i++) {
+            ctx.four = pristine.four;
+            facet_four(&ctx.four, group + i * INPUT_SIZE, INPUT_SIZE);
+            facet_four_close(&ctx.four, b[i]);
+            HoneyCombXorLanes(a[i], a[i], b[i], honey[i]);
+        }
+        for (size_t i = 0; i < lanes; i++) {
+            ctx.two = pristine.two;
+            facet_two(&ctx.two, a[i], LANE_SIZE);
+            facet_two_close(&ctx.two, a[i]);
+        }
+        for (size_t i = 0; i < lanes; i++) {
+            ctx.five = pristine.five;
+            facet_five(&ctx.five, group + i * INPUT_SIZE, INPUT_SIZE);
+            facet_five_close(&ctx.five, b[i]);
+            HoneyCombXorLanes(a[i], a[i], b[i], honey[i]);
+        }
+        for (size_t i = 0; i < lanes; i++) {
+            ctx.three = pristine.three;
+            facet_three(&ctx.three, a[i], LANE_SIZE);
+            facet_three_close(&ctx.three, a[i]);
+        }
+        for (size_t i = 0; i < lanes; i++) {
+            ctx.six = pristine.six;
+            facet_six(&ctx.six, group + i * INPUT_SIZE, INPUT_SIZE);
+            facet_six_close(&ctx.six, b[i]);
+            HoneyCombXorLanes(a[i], a[i], b[i], honey[i]);
+            memcpy(out + (pos + i) * CHoneyCombHasher::OUTPUT_SIZE, a[i], CHoneyCombHasher::OUTPUT_SIZE);
+        }
+    }
+}
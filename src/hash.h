@@ -304,56 +304,75 @@ public:
  */
 uint64_t SipHashUint256(uint64_t k0, uint64_t k1, const uint256& val);
 uint64_t SipHashUint256Extra(uint64_t k0, uint64_t k1, const uint256& val, uint32_t extra);
-inline uint512 HoneyBee( unsigned char *in, unsigned int sz ){
-	uint512 result;
-	memcpy( &result.begin()[ 0], &in[0],     36 );
-	memcpy( &result.begin()[36], &in[sz-28], 28 );
-	return result;    
-}
+
 /* ----------- Beenode Hash ------------------------------------------------ */
-template<typename T1> inline uint256 HashHoneyComb( const T1 pbegin, const T1 pend ){	
-    facet_one_context		ctx_one;
-	facet_two_context		ctx_two;
-	facet_three_context     ctx_three;
-    facet_four_context		ctx_four;
-	facet_five_context		ctx_five;
-	facet_six_context     	ctx_six;
-	static unsigned char pblank[1];
-    uint512 hash[12];
-	uint512 honey;
-   	uint512 buf;
-	honey = HoneyBee( (unsigned char*)static_cast<const void*>(&pbegin[0]), (pend-pbegin) * sizeof(pbegin[0]) );
-    facet_one_init(&ctx_one);
-    facet_one(&ctx_one, (pbegin == pend ? pblank : static_cast<const void*>(&pbegin[0])), (pend - pbegin) * sizeof(pbegin[0]) );
-    facet_one_close(&ctx_one, static_cast<void*>(&hash[0]));
-    facet_four_init(&ctx_four);
-    facet_four(&ctx_four, (pbegin == pend ? pblank : static_cast<const void*>(&pbegin[0])), (pend - pbegin) * sizeof(pbegin[0]));
-    facet_four_close(&ctx_four, static_cast<void*>(&hash[1]));
-    for(int i=0;i<512;i++)buf[i]= honey[i] ^ hash[1][i];
-    hash[2] = buf;buf.SetNull();
-    for(int i=0;i<512;i++)buf[i]= hash[0][i] ^ hash[2][i];
-	hash[3] = buf;buf.SetNull();	
-    facet_two_init( &ctx_two );
-    facet_two( &ctx_two, static_cast<const void*>(&hash[3]), 64 );
-    facet_two_close( &ctx_two, static_cast<void*>(&hash[4]) );
-    facet_five_init(&ctx_five);
-    facet_five (&ctx_five, (pbegin == pend ? pblank : static_cast<const void*>(&pbegin[0])), (pend - pbegin) * sizeof(pbegin[0]));
-    facet_five_close(&ctx_five, static_cast<void*>(&hash[5]));
-    for(int i=0;i<512;i++)buf[i]= honey[i] ^ hash[5][i];
-	hash[6] = buf;buf.SetNull();
-    for(int i=0;i<512;i++)buf[i]= hash[4][i] ^ hash[6][i];
-	hash[7] = buf;buf.SetNull();
-	facet_three_init(  &ctx_three  );
-    facet_three(  &ctx_three, static_cast<const void*>(&hash[7]), 64   );
-    facet_three_close(   &ctx_three, static_cast<void*>( &hash[8] )   );
-    facet_six_init(&ctx_six);
-    facet_six( &ctx_six, (pbegin == pend ? pblank : static_cast<const void*>(&pbegin[0])), (pend - pbegin) * sizeof(pbegin[0]) );
-    facet_six_close(&ctx_six, static_cast<void*>(&hash[9]));
-    for(int i=0;i<512;i++)buf[i]= honey[i] ^ hash[9][i];
-	hash[10] = buf;buf.SetNull();
-    for(int i=0;i<512;i++)buf[i]= hash[8][i] ^ hash[10][i];
-	hash[11] = buf;	
-	return hash[11].trim256();
-}	
+/** A hasher class for Beenode's HoneyComb proof-of-work hash.
+ *
+ *  The input is streamed through facets #1, #4, #5 and #6 at once, while the
+ *  first 36 and the last 28 bytes are kept aside as the "honey" lane. The
+ *  64-byte facet outputs are merged with the honey lane word-wise (SSE2/AVX2
+ *  when available) and chained through facets #2 and #3. A hasher can be
+ *  reused for many inputs by calling Reset(), which restores pristine facet
+ *  contexts with a plain copy instead of re-running every facet's init.
+ *
+ *  Inputs shorter than 64 bytes have the missing honey bytes treated as zero.
+ */
+class CHoneyCombHasher
+{
+public:
+    static const size_t OUTPUT_SIZE = 32;
+    static const size_t LANE_SIZE = 64;
+    static const size_t HONEY_HEAD = 36;
+    static const size_t HONEY_TAIL = 28;
+
+    struct FacetContexts {
+        facet_one_context one;
+        facet_four_context four;
+        facet_five_context five;
+        facet_six_context six;
+        facet_two_context two;
+        facet_three_context three;
+    };
+
+private:
+    FacetContexts ctx;
+    unsigned char head[HONEY_HEAD];
+    unsigned char tail[HONEY_TAIL];
+    uint64_t bytes;
+
+public:
+    CHoneyCombHasher();
+
+    CHoneyCombHasher& Write(const unsigned char* data, size_t len);
+    /** Compute the hash of the data written so far. Call Reset() before reusing the object. */
+    void Finalize(unsigned char hash[OUTPUT_SIZE]);
+    CHoneyCombHasher& Reset();
+};
+
+/** XOR three 64-byte HoneyComb lanes: out = a ^ b ^ c. Any of the pointers may alias. */
+void HoneyCombXorLanes(unsigned char* out, const unsigned char* a, const unsigned char* b, const unsigned char* c);
+
+/** Number of inputs HashHoneyComb80Batch runs through one facet before moving on to the next facet. */
+static const size_t HONEYCOMB_BATCH_LANES = 8;
+
+/** Compute the HoneyComb hashes of n consecutive 80-byte inputs (serialized block headers).
+ *
+ *  The inputs are processed HONEYCOMB_BATCH_LANES at a time and interleaved per facet:
+ *  every facet is applied to all lanes of a group before the next facet runs, so each
+ *  facet's code and tables stay hot in cache and the independent lanes keep the CPU busy.
+ *  out must have room for n * CHoneyCombHasher::OUTPUT_SIZE bytes.
+ */
+void HashHoneyComb80Batch(const unsigned char* in, size_t n, unsigned char* out);
+
+/** Compute the HoneyComb hash of an object. */
+template<typename T1>
+inline uint256 HashHoneyComb(const T1 pbegin, const T1 pend)
+{
+    static const unsigned char pblank[1] = {};
+    uint256 result;
+    CHoneyCombHasher().Write(pbegin == pend ? pblank : (const unsigned char*)&pbegin[0], (pend - pbegin) * sizeof(pbegin[0]))
+                      .Finalize((unsigned char*)&result);
+    return result;
+}
 
 #endif // BITCOIN_HASH_H
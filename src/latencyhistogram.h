@@ -0,0 +1,70 @@
+// Copyright (c) 2020 The BeeGroup developers are EternityGroup
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BEENODE_LATENCYHISTOGRAM_H
+#define BEENODE_LATENCYHISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Histogram of latencies, which can be updated and read from multiple threads without locking.
+ *
+ * Bucket i counts all samples below GetBucketLimit(i) milliseconds which did not fit into bucket i-1. The last bucket
+ * has no limit and counts all remaining samples.
+ */
+class CLatencyHistogram
+{
+public:
+    static const size_t BUCKET_COUNT = 14;
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets;
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> totalMicros{0};
+    std::atomic<uint64_t> maxMicros{0};
+
+public:
+    CLatencyHistogram()
+    {
+        for (auto& b : buckets) {
+            b = 0;
+        }
+    }
+
+    // Returns the upper limit of bucket i in milliseconds or -1 for the last bucket
+    static int64_t GetBucketLimit(size_t i)
+    {
+        static const int64_t limits[BUCKET_COUNT - 1] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+        return i < BUCKET_COUNT - 1 ? limits[i] : -1;
+    }
+
+    void Add(int64_t micros)
+    {
+        uint64_t v = micros < 0 ? 0 : (uint64_t)micros;
+        size_t i = 0;
+        while (i < BUCKET_COUNT - 1 && v >= (uint64_t)GetBucketLimit(i) * 1000) {
+            i++;
+        }
+        buckets[i]++;
+        count++;
+        totalMicros += v;
+
+        uint64_t curMax = maxMicros;
+        while (v > curMax && !maxMicros.compare_exchange_weak(curMax, v)) {
+        }
+    }
+
+    uint64_t GetCount() const { return count; }
+    uint64_t GetBucketCount(size_t i) const { return buckets[i]; }
+    uint64_t GetMaxMicros() const { return maxMicros; }
+    uint64_t GetAverageMicros() const
+    {
+        uint64_t c = count;
+        return c != 0 ? totalMicros / c : 0;
+    }
+};
+
+#endif // BEENODE_LATENCYHISTOGRAM_H
@@ -26,6 +26,7 @@ namespace llmq
 
 static const std::string DB_QUORUM_SK_SHARE = "q_Qsk";
 static const std::string DB_QUORUM_QUORUM_VVEC = "q_Qqvvec";
+static const std::string DB_QUORUM_PK_SHARE = "q_Qpks";
 
 CQuorumManager* quorumManager;
 
@@ -79,13 +80,37 @@ bool CQuorum::IsValidMember(const uint256& proTxHash) const
     return false;
 }
 
+static std::tuple<std::string, uint8_t, uint256, uint16_t> BuildPubKeyShareKey(const CQuorum& q, size_t memberIdx)
+{
+    return std::make_tuple(DB_QUORUM_PK_SHARE, (uint8_t)q.params.type, q.qc.quorumHash, (uint16_t)memberIdx);
+}
+
 CBLSPublicKey CQuorum::GetPubKeyShare(size_t memberIdx) const
 {
     if (quorumVvec == nullptr || memberIdx >= members.size() || !qc.validMembers[memberIdx]) {
         return CBLSPublicKey();
     }
     auto& m = members[memberIdx];
-    return blsCache.BuildPubKeyShare(m->proTxHash, quorumVvec, CBLSId::FromHash(m->proTxHash));
+    return blsCache.GetOrBuildPubKeyShare(m->proTxHash, [&]() {
+        // stored shares are only valid for the commitment they were recovered for, which might have changed in a reorg
+        auto dbKey = BuildPubKeyShareKey(*this, memberIdx);
+        std::pair<uint256, CBLSPublicKey> stored;
+        if (evoDb.Read(dbKey, stored) && stored.first == qc.quorumVvecHash && stored.second.IsValid()) {
+            return stored.second;
+        }
+
+        CBLSPublicKey pubKeyShare = blsWorker.BuildPubKeyShare(quorumVvec, CBLSId::FromHash(m->proTxHash));
+        if (pubKeyShare.IsValid()) {
+            evoDb.GetRawDB().Write(dbKey, std::make_pair(qc.quorumVvecHash, pubKeyShare));
+        }
+        return pubKeyShare;
+    });
+}
+
+bool CQuorum::HasStoredPubKeyShare(size_t memberIdx) const
+{
+    std::pair<uint256, CBLSPublicKey> stored;
+    return evoDb.Read(BuildPubKeyShareKey(*this, memberIdx), stored) && stored.first == qc.quorumVvecHash;
 }
 
 CBLSSecretKey CQuorum::GetSkShare() const
@@ -144,14 +169,17 @@ void CQuorum::StartCachePopulatorThread(std::shared_ptr<CQuorum> _this)
 
     // this thread will exit after some time
     // when then later some other thread tries to get keys, it will be much faster
+    // shares which were already recovered before (e.g. before a restart) are loaded lazily from the DB when needed
     _this->cachePopulatorThread = std::thread([_this, t]() {
         RenameThread("beenode-q-cachepop");
+        size_t recovered = 0;
         for (size_t i = 0; i < _this->members.size() && !_this->stopCachePopulatorThread && !ShutdownRequested(); i++) {
-            if (_this->qc.validMembers[i]) {
+            if (_this->qc.validMembers[i] && !_this->HasStoredPubKeyShare(i)) {
                 _this->GetPubKeyShare(i);
+                recovered++;
             }
         }
-        LogPrint("llmq", "CQuorum::StartCachePopulatorThread -- done. time=%d\n", t.count());
+        LogPrint("llmq", "CQuorum::StartCachePopulatorThread -- done. recovered=%d, time=%d\n", recovered, t.count());
     });
 }
 
@@ -401,7 +429,7 @@ CQuorumCPtr CQuorumManager::GetQuorum(Consensus::LLMQType llmqType, const CBlock
 
     auto& params = Params().GetConsensus().llmqs.at(llmqType);
 
-    auto quorum = std::make_shared<CQuorum>(params, blsWorker);
+    auto quorum = std::make_shared<CQuorum>(params, evoDb, blsWorker);
 
     if (!BuildQuorumFromCommitment(qc, pindexQuorum, minedBlockHash, quorum)) {
         return nullptr;
@@ -46,14 +46,18 @@ public:
     CBLSSecretKey skShare;
 
 private:
+    CEvoDB& evoDb;
+    CBLSWorker& blsWorker;
+
     // Recovery of public key shares is very slow, so we start a background thread that pre-populates a cache so that
-    // the public key shares are ready when needed later
+    // the public key shares are ready when needed later. Recovered shares are also written to the DB, so that they
+    // only have to be recovered once per quorum and member
     mutable CBLSWorkerCache blsCache;
     std::atomic<bool> stopCachePopulatorThread;
     std::thread cachePopulatorThread;
 
 public:
-    CQuorum(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker) : params(_params), blsCache(_blsWorker), stopCachePopulatorThread(false) {}
+    CQuorum(const Consensus::LLMQParams& _params, CEvoDB& _evoDb, CBLSWorker& _blsWorker) : params(_params), evoDb(_evoDb), blsWorker(_blsWorker), blsCache(_blsWorker), stopCachePopulatorThread(false) {}
     ~CQuorum();
     void Init(const CFinalCommitment& _qc, const CBlockIndex* _pindexQuorum, const uint256& _minedBlockHash, const std::vector<CDeterministicMNCPtr>& _members);
 
@@ -67,6 +71,7 @@ public:
 private:
     void WriteContributions(CEvoDB& evoDb);
     bool ReadContributions(CEvoDB& evoDb);
+    bool HasStoredPubKeyShare(size_t memberIdx) const;
     static void StartCachePopulatorThread(std::shared_ptr<CQuorum> _this);
 };
 typedef std::shared_ptr<CQuorum> CQuorumPtr;
@@ -24,6 +24,7 @@ CQuorumBlockProcessor* quorumBlockProcessor;
 
 static const std::string DB_MINED_COMMITMENT = "q_mc";
 static const std::string DB_MINED_COMMITMENT_BY_INVERSED_HEIGHT = "q_mcih";
+static const std::string DB_MINED_QUORUM_MEMBERS = "q_mqm";
 
 static const std::string DB_BEST_BLOCK_UPGRADE = "q_bbu2";
 
@@ -175,6 +176,17 @@ static std::tuple<std::string, uint8_t, uint32_t> BuildInversedHeightKey(Consens
     return std::make_tuple(DB_MINED_COMMITMENT_BY_INVERSED_HEIGHT, (uint8_t)llmqType, htobe32(std::numeric_limits<uint32_t>::max() - nMinedHeight));
 }
 
+static CMinedQuorumMembers BuildMinedQuorumMembers(const CFinalCommitment& qc, const std::vector<CDeterministicMNCPtr>& members)
+{
+    CMinedQuorumMembers minedMembers;
+    minedMembers.internalIds.reserve(members.size());
+    for (const auto& dmn : members) {
+        minedMembers.internalIds.emplace_back(dmn->internalId);
+    }
+    minedMembers.validMembers = qc.validMembers;
+    return minedMembers;
+}
+
 bool CQuorumBlockProcessor::ProcessCommitment(int nHeight, const uint256& blockHash, const CFinalCommitment& qc, CValidationState& state)
 {
     auto& params = Params().GetConsensus().llmqs.at((Consensus::LLMQType)qc.llmqType);
@@ -214,6 +226,7 @@ bool CQuorumBlockProcessor::ProcessCommitment(int nHeight, const uint256& blockH
     // Store commitment in DB
     evoDb.Write(std::make_pair(DB_MINED_COMMITMENT, std::make_pair((uint8_t)params.type, quorumHash)), std::make_pair(qc, blockHash));
     evoDb.Write(BuildInversedHeightKey(params.type, nHeight), quorumIndex->nHeight);
+    evoDb.Write(std::make_pair(DB_MINED_QUORUM_MEMBERS, std::make_pair((uint8_t)params.type, quorumHash)), BuildMinedQuorumMembers(qc, members));
 
     {
         LOCK(minableCommitmentsCs);
@@ -244,6 +257,7 @@ bool CQuorumBlockProcessor::UndoBlock(const CBlock& block, const CBlockIndex* pi
 
         evoDb.Erase(std::make_pair(DB_MINED_COMMITMENT, std::make_pair(qc.llmqType, qc.quorumHash)));
         evoDb.Erase(BuildInversedHeightKey((Consensus::LLMQType)qc.llmqType, pindex->nHeight));
+        evoDb.Erase(std::make_pair(DB_MINED_QUORUM_MEMBERS, std::make_pair(qc.llmqType, qc.quorumHash)));
         {
             LOCK(minableCommitmentsCs);
             hasMinedCommitmentCache.erase(std::make_pair((Consensus::LLMQType)qc.llmqType, qc.quorumHash));
@@ -288,6 +302,8 @@ void CQuorumBlockProcessor::UpgradeDB()
                 auto quorumIndex = mapBlockIndex.at(qc.quorumHash);
                 evoDb.GetRawDB().Write(std::make_pair(DB_MINED_COMMITMENT, std::make_pair((uint8_t)qc.llmqType, qc.quorumHash)), std::make_pair(qc, pindex->GetBlockHash()));
                 evoDb.GetRawDB().Write(BuildInversedHeightKey((Consensus::LLMQType)qc.llmqType, pindex->nHeight), quorumIndex->nHeight);
+                auto members = CLLMQUtils::GetAllQuorumMembers((Consensus::LLMQType)qc.llmqType, quorumIndex);
+                evoDb.GetRawDB().Write(std::make_pair(DB_MINED_QUORUM_MEMBERS, std::make_pair((uint8_t)qc.llmqType, qc.quorumHash)), BuildMinedQuorumMembers(qc, members));
             }
 
             evoDb.GetRawDB().Write(DB_BEST_BLOCK_UPGRADE, pindex->GetBlockHash());
@@ -402,6 +418,11 @@ bool CQuorumBlockProcessor::GetMinedCommitment(Consensus::LLMQType llmqType, con
     return true;
 }
 
+bool CQuorumBlockProcessor::GetMinedQuorumMembers(Consensus::LLMQType llmqType, const uint256& quorumHash, CMinedQuorumMembers& ret)
+{
+    return evoDb.Read(std::make_pair(DB_MINED_QUORUM_MEMBERS, std::make_pair((uint8_t)llmqType, quorumHash)), ret);
+}
+
 std::vector<const CBlockIndex*> CQuorumBlockProcessor::GetMinedCommitmentsUntilBlock(Consensus::LLMQType llmqType, const CBlockIndex* pindex, size_t maxCount)
 {
     auto dbIt = evoDb.GetCurTransaction().NewIteratorUniquePtr();
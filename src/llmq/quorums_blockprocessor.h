@@ -22,6 +22,25 @@ class CConnman;
 namespace llmq
 {
 
+// Members of a mined quorum, written together with the commitment so that quorums can be built without calculating
+// the scores of the whole MN list again
+class CMinedQuorumMembers
+{
+public:
+    std::vector<uint64_t> internalIds;
+    CCompactBitSet validMembers;
+
+public:
+    ADD_SERIALIZE_METHODS
+
+    template<typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action)
+    {
+        READWRITE(internalIds);
+        READWRITE(DYNBITSET(validMembers));
+    }
+};
+
 class CQuorumBlockProcessor
 {
 private:
@@ -52,6 +71,7 @@ public:
 
     bool HasMinedCommitment(Consensus::LLMQType llmqType, const uint256& quorumHash);
     bool GetMinedCommitment(Consensus::LLMQType llmqType, const uint256& quorumHash, CFinalCommitment& ret, uint256& retMinedBlockHash);
+    bool GetMinedQuorumMembers(Consensus::LLMQType llmqType, const uint256& quorumHash, CMinedQuorumMembers& ret);
 
     std::vector<const CBlockIndex*> GetMinedCommitmentsUntilBlock(Consensus::LLMQType llmqType, const CBlockIndex* pindex, size_t maxCount);
     std::map<Consensus::LLMQType, std::vector<const CBlockIndex*>> GetMinedAndActiveCommitmentsUntilBlock(const CBlockIndex* pindex);
@@ -132,6 +132,17 @@ void CChainLocksHandler::ProcessNewChainLock(NodeId from, const llmq::CChainLock
         bestChainLockHash = hash;
         bestChainLock = clsig;
 
+        auto tipTimeIt = blockTipTimes.find(clsig.blockHash);
+        if (tipTimeIt != blockTipTimes.end()) {
+            int64_t micros = GetTimeMicros() - tipTimeIt->second;
+            tipToChainLock.Add(micros);
+            recentChainLockLatencies.push_back({clsig.nHeight, clsig.blockHash, micros});
+            if (recentChainLockLatencies.size() > MAX_RECENT_CHAINLOCK_LATENCIES) {
+                recentChainLockLatencies.pop_front();
+            }
+            blockTipTimes.erase(tipTimeIt);
+        }
+
         CInv inv(MSG_CLSIG, hash);
         g_connman->RelayInv(inv, LLMQS_PROTO_VERSION);
 
@@ -187,10 +198,15 @@ void CChainLocksHandler::AcceptedBlockHeader(const CBlockIndex* pindexNew)
 
 void CChainLocksHandler::UpdatedBlockTip(const CBlockIndex* pindexNew)
 {
+    // Sig shares for the new tip will start to arrive soon, make sure they are handled before everything else
+    uint256 requestId = ::SerializeHash(std::make_pair(CLSIG_REQUESTID_PREFIX, pindexNew->nHeight));
+    quorumSigningManager->AddPriorityRequestId(Params().GetConsensus().llmqChainLocks, requestId);
+
     // don't call TrySignChainTip directly but instead let the scheduler call it. This way we ensure that cs_main is
     // never locked and TrySignChainTip is not called twice in parallel. Also avoids recursive calls due to
     // EnforceBestChainLock switching chains.
     LOCK(cs);
+    blockTipTimes.emplace(pindexNew->GetBlockHash(), GetTimeMicros());
     if (tryLockChainTipScheduled) {
         return;
     }
@@ -342,6 +358,8 @@ void CChainLocksHandler::TrySignChainTip()
         lastSignedMsgHash = msgHash;
     }
 
+    // usually already done in UpdatedBlockTip, but the entry might have timed out while waiting for ixlocks
+    quorumSigningManager->AddPriorityRequestId(Params().GetConsensus().llmqChainLocks, requestId);
     quorumSigningManager->AsyncSignIfMember(Params().GetConsensus().llmqChainLocks, requestId, msgHash);
 }
 
@@ -436,6 +454,12 @@ CChainLocksHandler::BlockTxs::mapped_type CChainLocksHandler::GetBlockTxs(const
     return ret;
 }
 
+std::vector<CChainLockLatency> CChainLocksHandler::GetRecentChainLockLatencies()
+{
+    LOCK(cs);
+    return std::vector<CChainLockLatency>(recentChainLockLatencies.begin(), recentChainLockLatencies.end());
+}
+
 bool CChainLocksHandler::IsTxSafeForMining(const uint256& txid)
 {
     if (!sporkManager.IsSporkActive(SPORK_3_INSTANTSEND_BLOCK_FILTERING)) {
@@ -676,6 +700,14 @@ void CChainLocksHandler::Cleanup()
             ++it;
         }
     }
+    // blocks which never got ChainLocked (e.g. because they were reorged)
+    for (auto it = blockTipTimes.begin(); it != blockTipTimes.end(); ) {
+        if (GetTimeMicros() - it->second >= CLEANUP_SEEN_TIMEOUT * 1000) {
+            it = blockTipTimes.erase(it);
+        } else {
+            ++it;
+        }
+    }
 
     for (auto it = blockTxs.begin(); it != blockTxs.end(); ) {
         auto pindex = mapBlockIndex.at(it->first);
@@ -10,8 +10,10 @@
 
 #include "net.h"
 #include "chainparams.h"
+#include "latencyhistogram.h"
 
 #include <atomic>
+#include <deque>
 #include <unordered_set>
 
 class CBlockIndex;
@@ -41,6 +43,14 @@ public:
     std::string ToString() const;
 };
 
+// Time it took from a block becoming our chain tip until it got ChainLocked
+struct CChainLockLatency
+{
+    int32_t nHeight;
+    uint256 blockHash;
+    int64_t micros;
+};
+
 class CChainLocksHandler : public CRecoveredSigsListener
 {
     static const int64_t CLEANUP_INTERVAL = 1000 * 30;
@@ -49,6 +59,8 @@ class CChainLocksHandler : public CRecoveredSigsListener
     // how long to wait for ixlocks until we consider a block with non-ixlocked TXs to be safe to sign
     static const int64_t WAIT_FOR_ISLOCK_TIMEOUT = 10 * 60;
 
+    static const size_t MAX_RECENT_CHAINLOCK_LATENCIES = 100;
+
 private:
     CScheduler* scheduler;
     CCriticalSection cs;
@@ -74,6 +86,11 @@ private:
 
     std::map<uint256, int64_t> seenChainLocks;
 
+    // time (in microseconds) when blocks became the chain tip. Used to measure the time until they get ChainLocked
+    std::unordered_map<uint256, int64_t> blockTipTimes;
+    CLatencyHistogram tipToChainLock;
+    std::deque<CChainLockLatency> recentChainLockLatencies;
+
     int64_t lastCleanupTime{0};
 
 public:
@@ -101,6 +118,9 @@ public:
 
     bool IsTxSafeForMining(const uint256& txid);
 
+    const CLatencyHistogram& GetTipToChainLockStats() const { return tipToChainLock; }
+    std::vector<CChainLockLatency> GetRecentChainLockLatencies();
+
 private:
     // these require locks to be held already
     bool InternalHasChainLock(int nHeight, const uint256& blockHash);
@@ -5,6 +5,7 @@
 #ifndef BEENODE_QUORUMS_COMMITMENT_H
 #define BEENODE_QUORUMS_COMMITMENT_H
 
+#include "compactbitset.h"
 #include "consensus/params.h"
 
 #include "evo/deterministicmns.h"
@@ -26,8 +27,8 @@ public:
     uint16_t nVersion{CURRENT_VERSION};
     uint8_t llmqType{Consensus::LLMQ_NONE};
     uint256 quorumHash;
-    std::vector<bool> signers;
-    std::vector<bool> validMembers;
+    CCompactBitSet signers;
+    CCompactBitSet validMembers;
 
     CBLSPublicKey quorumPublicKey;
     uint256 quorumVvecHash;
@@ -41,11 +42,11 @@ public:
 
     int CountSigners() const
     {
-        return (int)std::count(signers.begin(), signers.end(), true);
+        return (int)signers.count();
     }
     int CountValidMembers() const
     {
-        return (int)std::count(validMembers.begin(), validMembers.end(), true);
+        return (int)validMembers.count();
     }
 
     bool Verify(const std::vector<CDeterministicMNCPtr>& members, bool checkSigs) const;
@@ -74,8 +75,7 @@ public:
 public:
     bool IsNull() const
     {
-        if (std::count(signers.begin(), signers.end(), true) ||
-            std::count(validMembers.begin(), validMembers.end(), true)) {
+        if (signers.any() || validMembers.any()) {
             return false;
         }
         if (quorumPublicKey.IsValid() ||
@@ -8,12 +8,27 @@
 #include "validation.h"
 
 #include "evo/deterministicmns.h"
+#include "quorums_dkgsessionhandler.h"
 #include "quorums_utils.h"
 
 namespace llmq
 {
 CDKGDebugManager* quorumDKGDebugManager;
 
+static std::string GetPhaseName(uint8_t phase)
+{
+    switch (phase) {
+    case QuorumPhase_Initialized: return "initialized";
+    case QuorumPhase_Contribute: return "contribute";
+    case QuorumPhase_Complain: return "complain";
+    case QuorumPhase_Justify: return "justify";
+    case QuorumPhase_Commit: return "commit";
+    case QuorumPhase_Finalize: return "finalize";
+    case QuorumPhase_Idle: return "idle";
+    default: return strprintf("%d", phase);
+    }
+}
+
 UniValue CDKGDebugSessionStatus::ToJson(int detailLevel) const
 {
     UniValue ret(UniValue::VOBJ);
@@ -101,6 +116,16 @@ UniValue CDKGDebugSessionStatus::ToJson(int detailLevel) const
     push(receivedJustifications, "receivedJustifications");
     push(receivedPrematureCommitments, "receivedPrematureCommitments");
 
+    UniValue phaseStatsJson(UniValue::VOBJ);
+    for (const auto& p : phaseStats) {
+        UniValue o(UniValue::VOBJ);
+        o.push_back(Pair("time", p.second.timeMicros / 1000));
+        o.push_back(Pair("bytes", p.second.bytes));
+        o.push_back(Pair("messages", (int)p.second.messages));
+        phaseStatsJson.push_back(Pair(GetPhaseName(p.first), o));
+    }
+    ret.push_back(Pair("phaseStats", phaseStatsJson));
+
     if (detailLevel == 2) {
         UniValue arr(UniValue::VARR);
         for (const auto& dmn : dmnMembers) {
@@ -174,6 +199,7 @@ void CDKGDebugManager::InitLocalSessionStatus(Consensus::LLMQType llmqType, cons
     session.statusBitset = 0;
     session.members.clear();
     session.members.resize((size_t)params.size);
+    session.phaseStats.clear();
 }
 
 void CDKGDebugManager::UpdateLocalStatus(std::function<bool(CDKGDebugStatus& status)>&& func)
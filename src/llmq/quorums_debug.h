@@ -44,6 +44,15 @@ public:
     CDKGDebugMemberStatus() : statusBitset(0) {}
 };
 
+class CDKGDebugPhaseStats
+{
+public:
+    // wall time spent in the local actions and in processing incoming messages of the phase
+    int64_t timeMicros{0};
+    uint64_t bytes{0};
+    uint32_t messages{0};
+};
+
 class CDKGDebugSessionStatus
 {
 public:
@@ -68,6 +77,9 @@ public:
 
     std::vector<CDKGDebugMemberStatus> members;
 
+    // indexed by phase
+    std::map<uint8_t, CDKGDebugPhaseStats> phaseStats;
+
 public:
     CDKGDebugSessionStatus() : statusBitset(0) {}
 
@@ -88,6 +88,16 @@ CDKGMember::CDKGMember(CDeterministicMNCPtr _dmn, size_t _idx) :
 
 }
 
+CDKGSession::~CDKGSession()
+{
+    // the BLS worker might still reference the vectors of unfinished batches
+    for (auto& batch : contributionVerificationBatches) {
+        if (batch.result.valid()) {
+            batch.result.wait();
+        }
+    }
+}
+
 bool CDKGSession::Init(const CBlockIndex* _pindexQuorum, const std::vector<CDeterministicMNCPtr>& mns, const uint256& _myProTxHash)
 {
     if (mns.size() < params.minSize) {
@@ -338,70 +348,84 @@ void CDKGSession::ReceiveMessage(const uint256& hash, const CDKGContribution& qc
 
     logger.Batch("decrypted our contribution share. time=%d", t2.count());
 
-    bool verifyPending = false;
     receivedSkContributions[member->idx] = skContribution;
     pendingContributionVerifications.emplace_back(member->idx);
     if (pendingContributionVerifications.size() >= 32) {
-        verifyPending = true;
-    }
-
-    if (verifyPending) {
-        VerifyPendingContributions();
+        StartPendingContributionVerifications();
     }
 }
 
-// Verifies all pending secret key contributions in one batch
+// Starts verification of all pending secret key contributions in one batch on the BLS worker threads
 // This is done by aggregating the verification vectors belonging to the secret key contributions
 // The resulting aggregated vvec is then used to recover a public key share
 // The public key share must match the public key belonging to the aggregated secret key contributions
 // See CBLSWorker::VerifyContributionShares for more details.
-void CDKGSession::VerifyPendingContributions()
+void CDKGSession::StartPendingContributionVerifications()
 {
-    CDKGLogger logger(*this, __func__);
-
-    cxxtimer::Timer t1(true);
-
     std::vector<size_t> pend = std::move(pendingContributionVerifications);
     if (pend.empty()) {
         return;
     }
 
-    std::vector<size_t> memberIndexes;
-    std::vector<BLSVerificationVectorPtr> vvecs;
-    BLSSecretKeyVector skContributions;
+    contributionVerificationBatches.emplace_back();
+    auto& batch = contributionVerificationBatches.back();
 
     for (const auto& idx : pend) {
         auto& m = members[idx];
         if (m->bad || m->weComplain) {
             continue;
         }
-        memberIndexes.emplace_back(idx);
-        vvecs.emplace_back(receivedVvecs[idx]);
-        skContributions.emplace_back(receivedSkContributions[idx]);
+        batch.memberIndexes.emplace_back(idx);
+        batch.vvecs.emplace_back(receivedVvecs[idx]);
+        batch.skContributions.emplace_back(receivedSkContributions[idx]);
+    }
+    if (batch.memberIndexes.empty()) {
+        contributionVerificationBatches.pop_back();
+        return;
     }
 
-    auto result = blsWorker.VerifyContributionShares(myId, vvecs, skContributions);
-    if (result.size() != memberIndexes.size()) {
-        logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), memberIndexes.size());
+    batch.result = blsWorker.AsyncVerifyContributionShares(myId, batch.vvecs, batch.skContributions, true, true);
+}
+
+// Waits for all contribution verifications (including the ones which are still pending) to finish and handles the
+// results
+void CDKGSession::VerifyPendingContributions()
+{
+    CDKGLogger logger(*this, __func__);
+
+    cxxtimer::Timer t1(true);
+
+    StartPendingContributionVerifications();
+    if (contributionVerificationBatches.empty()) {
         return;
     }
 
-    for (size_t i = 0; i < memberIndexes.size(); i++) {
-        if (!result[i]) {
-            auto& m = members[memberIndexes[i]];
-            logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
-            m->weComplain = true;
-            quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
-                status.weComplain = true;
-                return true;
-            });
-        } else {
-            size_t memberIdx = memberIndexes[i];
-            dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, members[memberIdx]->dmn->proTxHash, skContributions[i]);
+    size_t verifiedCount = 0;
+    for (auto& batch : contributionVerificationBatches) {
+        auto result = batch.result.get();
+        if (result.size() != batch.memberIndexes.size()) {
+            logger.Batch("VerifyContributionShares returned result of size %d but size %d was expected, something is wrong", result.size(), batch.memberIndexes.size());
+            continue;
+        }
+
+        for (size_t i = 0; i < batch.memberIndexes.size(); i++) {
+            auto& m = members[batch.memberIndexes[i]];
+            if (!result[i]) {
+                logger.Batch("invalid contribution from %s. will complain later", m->dmn->proTxHash.ToString());
+                m->weComplain = true;
+                quorumDKGDebugManager->UpdateLocalMemberStatus(params.type, m->idx, [&](CDKGDebugMemberStatus& status) {
+                    status.weComplain = true;
+                    return true;
+                });
+            } else {
+                dkgManager.WriteVerifiedSkContribution(params.type, pindexQuorum, m->dmn->proTxHash, batch.skContributions[i]);
+            }
         }
+        verifiedCount += batch.memberIndexes.size();
     }
+    contributionVerificationBatches.clear();
 
-    logger.Batch("verified %d pending contributions. time=%d", pend.size(), t1.count());
+    logger.Batch("verified %d pending contributions. waitTime=%d", verifiedCount, t1.count());
 }
 
 void CDKGSession::VerifyAndComplain(CDKGPendingMessages& pendingMessages)
@@ -1160,7 +1184,7 @@ std::vector<CFinalCommitment> CDKGSession::FinalizeCommitments()
 
     cxxtimer::Timer totalTimer(true);
 
-    typedef std::vector<bool> Key;
+    typedef CCompactBitSet Key;
     std::map<Key, std::vector<CDKGPrematureCommitment>> commitmentsMap;
 
     for (const auto& p : prematureCommitments) {
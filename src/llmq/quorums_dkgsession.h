@@ -91,8 +91,8 @@ public:
     uint8_t llmqType;
     uint256 quorumHash;
     uint256 proTxHash;
-    std::vector<bool> badMembers;
-    std::vector<bool> complainForMembers;
+    CCompactBitSet badMembers;
+    CCompactBitSet complainForMembers;
     CBLSSignature sig;
 
 public:
@@ -160,7 +160,7 @@ public:
     uint8_t llmqType;
     uint256 quorumHash;
     uint256 proTxHash;
-    std::vector<bool> validMembers;
+    CCompactBitSet validMembers;
 
     CBLSPublicKey quorumPublicKey;
     uint256 quorumVvecHash;
@@ -174,7 +174,7 @@ public:
 
     int CountValidMembers() const
     {
-        return (int)std::count(validMembers.begin(), validMembers.end(), true);
+        return (int)validMembers.count();
     }
 
 public:
@@ -279,12 +279,24 @@ private:
 
     std::vector<size_t> pendingContributionVerifications;
 
+    // Batches of received contributions which are verified asynchronously on the BLS worker threads while we're still
+    // receiving contributions. The vectors must stay alive until verification has finished, as the BLS worker only
+    // holds references to them.
+    struct ContributionVerificationBatch {
+        std::vector<size_t> memberIndexes;
+        std::vector<BLSVerificationVectorPtr> vvecs;
+        BLSSecretKeyVector skContributions;
+        std::future<std::vector<bool>> result;
+    };
+    std::list<ContributionVerificationBatch> contributionVerificationBatches;
+
     // filled by ReceivePrematureCommitment and used by FinalizeCommitments
     std::set<uint256> validCommitments;
 
 public:
     CDKGSession(const Consensus::LLMQParams& _params, CBLSWorker& _blsWorker, CDKGSessionManager& _dkgManager) :
         params(_params), blsWorker(_blsWorker), cache(_blsWorker), dkgManager(_dkgManager) {}
+    ~CDKGSession();
 
     bool Init(const CBlockIndex* pindexQuorum, const std::vector<CDeterministicMNCPtr>& mns, const uint256& _myProTxHash);
 
@@ -308,6 +320,7 @@ public:
     void SendContributions(CDKGPendingMessages& pendingMessages);
     bool PreVerifyMessage(const uint256& hash, const CDKGContribution& qc, bool& retBan) const;
     void ReceiveMessage(const uint256& hash, const CDKGContribution& qc, bool& retBan);
+    void StartPendingContributionVerifications();
     void VerifyPendingContributions();
 
     // Phase 2: complaint
@@ -261,9 +261,29 @@ void CDKGSessionHandler::HandlePhase(QuorumPhase curPhase,
                                      const StartPhaseFunc& startPhaseFunc,
                                      const WhileWaitFunc& runWhileWaiting)
 {
-    SleepBeforePhase(curPhase, expectedQuorumHash, randomSleepFactor, runWhileWaiting);
+    // only account for the time in which we actually did something, not for the time spent sleeping
+    WhileWaitFunc timedRunWhileWaiting = [&]() {
+        int64_t nTime = GetTimeMicros();
+        bool didWork = runWhileWaiting();
+        if (didWork) {
+            AddPhaseTime(curPhase, GetTimeMicros() - nTime);
+        }
+        return didWork;
+    };
+
+    SleepBeforePhase(curPhase, expectedQuorumHash, randomSleepFactor, timedRunWhileWaiting);
+    int64_t nTime = GetTimeMicros();
     startPhaseFunc();
-    WaitForNextPhase(curPhase, nextPhase, expectedQuorumHash, runWhileWaiting);
+    AddPhaseTime(curPhase, GetTimeMicros() - nTime);
+    WaitForNextPhase(curPhase, nextPhase, expectedQuorumHash, timedRunWhileWaiting);
+}
+
+void CDKGSessionHandler::AddPhaseTime(QuorumPhase phase, int64_t timeMicros)
+{
+    quorumDKGDebugManager->UpdateLocalSessionStatus(params.type, [&](CDKGDebugSessionStatus& status) {
+        status.phaseStats[(uint8_t)phase].timeMicros += timeMicros;
+        return true;
+    });
 }
 
 // returns a set of NodeIds which sent invalid messages
@@ -362,13 +382,21 @@ std::set<NodeId> BatchVerifyMessageSigs(CDKGSession& session, const std::vector<
 }
 
 template<typename Message>
-bool ProcessPendingMessageBatch(CDKGSession& session, CDKGPendingMessages& pendingMessages, size_t maxCount)
+bool ProcessPendingMessageBatch(Consensus::LLMQType llmqType, CDKGSession& session, CDKGPendingMessages& pendingMessages, size_t maxCount)
 {
-    auto msgs = pendingMessages.PopAndDeserializeMessages<Message>(maxCount);
+    size_t bytes = 0;
+    auto msgs = pendingMessages.PopAndDeserializeMessages<Message>(maxCount, bytes);
     if (msgs.empty()) {
         return false;
     }
 
+    quorumDKGDebugManager->UpdateLocalSessionStatus(llmqType, [&](CDKGDebugSessionStatus& status) {
+        auto& stats = status.phaseStats[status.phase];
+        stats.bytes += bytes;
+        stats.messages += msgs.size();
+        return true;
+    });
+
     std::vector<uint256> hashes;
     std::vector<std::pair<NodeId, std::shared_ptr<Message>>> preverifiedMessages;
     hashes.reserve(msgs.size());
@@ -508,7 +536,7 @@ void CDKGSessionHandler::HandleDKGRound()
         curSession->Contribute(pendingContributions);
     };
     auto fContributeWait = [this] {
-        return ProcessPendingMessageBatch<CDKGContribution>(*curSession, pendingContributions, 8);
+        return ProcessPendingMessageBatch<CDKGContribution>(params.type, *curSession, pendingContributions, 8);
     };
     HandlePhase(QuorumPhase_Contribute, QuorumPhase_Complain, curQuorumHash, 0.05, fContributeStart, fContributeWait);
 
@@ -517,7 +545,7 @@ void CDKGSessionHandler::HandleDKGRound()
         curSession->VerifyAndComplain(pendingComplaints);
     };
     auto fComplainWait = [this] {
-        return ProcessPendingMessageBatch<CDKGComplaint>(*curSession, pendingComplaints, 8);
+        return ProcessPendingMessageBatch<CDKGComplaint>(params.type, *curSession, pendingComplaints, 8);
     };
     HandlePhase(QuorumPhase_Complain, QuorumPhase_Justify, curQuorumHash, 0.05, fComplainStart, fComplainWait);
 
@@ -526,7 +554,7 @@ void CDKGSessionHandler::HandleDKGRound()
         curSession->VerifyAndJustify(pendingJustifications);
     };
     auto fJustifyWait = [this] {
-        return ProcessPendingMessageBatch<CDKGJustification>(*curSession, pendingJustifications, 8);
+        return ProcessPendingMessageBatch<CDKGJustification>(params.type, *curSession, pendingJustifications, 8);
     };
     HandlePhase(QuorumPhase_Justify, QuorumPhase_Commit, curQuorumHash, 0.05, fJustifyStart, fJustifyWait);
 
@@ -535,7 +563,7 @@ void CDKGSessionHandler::HandleDKGRound()
         curSession->VerifyAndCommit(pendingPrematureCommitments);
     };
     auto fCommitWait = [this] {
-        return ProcessPendingMessageBatch<CDKGPrematureCommitment>(*curSession, pendingPrematureCommitments, 8);
+        return ProcessPendingMessageBatch<CDKGPrematureCommitment>(params.type, *curSession, pendingPrematureCommitments, 8);
     };
     HandlePhase(QuorumPhase_Commit, QuorumPhase_Finalize, curQuorumHash, 0.1, fCommitStart, fCommitWait);
 
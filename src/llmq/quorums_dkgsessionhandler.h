@@ -62,8 +62,9 @@ public:
     }
 
     // Might return nullptr messages, which indicates that deserialization failed for some reason
+    // The serialized size of all popped messages is added to retBytes
     template<typename Message>
-    std::vector<std::pair<NodeId, std::shared_ptr<Message>>> PopAndDeserializeMessages(size_t maxCount)
+    std::vector<std::pair<NodeId, std::shared_ptr<Message>>> PopAndDeserializeMessages(size_t maxCount, size_t& retBytes)
     {
         auto binaryMessages = PopPendingMessages(maxCount);
         if (binaryMessages.empty()) {
@@ -73,6 +74,7 @@ public:
         std::vector<std::pair<NodeId, std::shared_ptr<Message>>> ret;
         ret.reserve(binaryMessages.size());
         for (const auto& bm : binaryMessages) {
+            retBytes += bm.second->size();
             auto msg = std::make_shared<Message>();
             try {
                 *bm.second >> *msg;
@@ -134,6 +136,7 @@ private:
     void WaitForNextPhase(QuorumPhase curPhase, QuorumPhase nextPhase, const uint256& expectedQuorumHash, const WhileWaitFunc& runWhileWaiting);
     void WaitForNewQuorum(const uint256& oldQuorumHash);
     void SleepBeforePhase(QuorumPhase curPhase, const uint256& expectedQuorumHash, double randomSleepFactor, const WhileWaitFunc& runWhileWaiting);
+    void AddPhaseTime(QuorumPhase phase, int64_t timeMicros);
     void HandlePhase(QuorumPhase curPhase, QuorumPhase nextPhase, const uint256& expectedQuorumHash, double randomSleepFactor, const StartPhaseFunc& startPhaseFunc, const WhileWaitFunc& runWhileWaiting);
     void HandleDKGRound();
     void PhaseHandlerThread();
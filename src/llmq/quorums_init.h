@@ -5,6 +5,7 @@
 #ifndef BEENODE_QUORUMS_INIT_H
 #define BEENODE_QUORUMS_INIT_H
 
+class CBLSWorker;
 class CDBWrapper;
 class CEvoDB;
 class CScheduler;
@@ -15,6 +16,8 @@ namespace llmq
 // If true, we will connect to all new quorums and watch their communication
 static const bool DEFAULT_WATCH_QUORUMS = false;
 
+extern CBLSWorker* blsWorker;
+
 // Init/destroy LLMQ globals
 void InitLLMQSystem(CEvoDB& evoDb, CScheduler* scheduler, bool unitTests, bool fWipe = false);
 void DestroyLLMQSystem();
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "quorums_signing.h"
+#include "quorums_init.h"
 #include "quorums_utils.h"
 #include "quorums_signing_shares.h"
 
@@ -37,7 +38,9 @@ UniValue CRecoveredSig::ToJson() const
 }
 
 CRecoveredSigsDb::CRecoveredSigsDb(CDBWrapper& _db) :
-    db(_db)
+    db(_db),
+    pendingBatch(_db),
+    pendingWrites(_db, pendingBatch)
 {
     if (Params().NetworkIDString() == CBaseChainParams::TESTNET) {
         // TODO this can be completely removed after some time (when we're pretty sure the conversion has been run on most testnet MNs)
@@ -52,6 +55,11 @@ CRecoveredSigsDb::CRecoveredSigsDb(CDBWrapper& _db) :
     }
 }
 
+CRecoveredSigsDb::~CRecoveredSigsDb()
+{
+    CommitPendingWrites();
+}
+
 // This converts time values in "rs_t" from host endiannes to big endiannes, which is required to have proper ordering of the keys
 void CRecoveredSigsDb::ConvertInvalidTimeKeys()
 {
@@ -128,25 +136,21 @@ void CRecoveredSigsDb::AddVoteTimeKeys()
 bool CRecoveredSigsDb::HasRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash)
 {
     auto k = std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id, msgHash);
-    return db.Exists(k);
+    LOCK(cs);
+    return pendingWrites.Exists(k);
 }
 
 bool CRecoveredSigsDb::HasRecoveredSigForId(Consensus::LLMQType llmqType, const uint256& id)
 {
     auto cacheKey = std::make_pair(llmqType, id);
     bool ret;
-    {
-        LOCK(cs);
-        if (hasSigForIdCache.get(cacheKey, ret)) {
-            return ret;
-        }
+    LOCK(cs);
+    if (hasSigForIdCache.get(cacheKey, ret)) {
+        return ret;
     }
 
-
     auto k = std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id);
-    ret = db.Exists(k);
-
-    LOCK(cs);
+    ret = pendingWrites.Exists(k);
     hasSigForIdCache.insert(cacheKey, ret);
     return ret;
 }
@@ -154,17 +158,13 @@ bool CRecoveredSigsDb::HasRecoveredSigForId(Consensus::LLMQType llmqType, const
 bool CRecoveredSigsDb::HasRecoveredSigForSession(const uint256& signHash)
 {
     bool ret;
-    {
-        LOCK(cs);
-        if (hasSigForSessionCache.get(signHash, ret)) {
-            return ret;
-        }
+    LOCK(cs);
+    if (hasSigForSessionCache.get(signHash, ret)) {
+        return ret;
     }
 
     auto k = std::make_tuple(std::string("rs_s"), signHash);
-    ret = db.Exists(k);
-
-    LOCK(cs);
+    ret = pendingWrites.Exists(k);
     hasSigForSessionCache.insert(signHash, ret);
     return ret;
 }
@@ -172,17 +172,13 @@ bool CRecoveredSigsDb::HasRecoveredSigForSession(const uint256& signHash)
 bool CRecoveredSigsDb::HasRecoveredSigForHash(const uint256& hash)
 {
     bool ret;
-    {
-        LOCK(cs);
-        if (hasSigForHashCache.get(hash, ret)) {
-            return ret;
-        }
+    LOCK(cs);
+    if (hasSigForHashCache.get(hash, ret)) {
+        return ret;
     }
 
     auto k = std::make_tuple(std::string("rs_h"), hash);
-    ret = db.Exists(k);
-
-    LOCK(cs);
+    ret = pendingWrites.Exists(k);
     hasSigForHashCache.insert(hash, ret);
     return ret;
 }
@@ -190,26 +186,19 @@ bool CRecoveredSigsDb::HasRecoveredSigForHash(const uint256& hash)
 bool CRecoveredSigsDb::ReadRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, CRecoveredSig& ret)
 {
     auto k = std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id);
-
-    CDataStream ds(SER_DISK, CLIENT_VERSION);
-    if (!db.ReadDataStream(k, ds)) {
-        return false;
-    }
-
-    try {
-        ret.Unserialize(ds);
-        return true;
-    } catch (std::exception&) {
-        return false;
-    }
+    LOCK(cs);
+    return pendingWrites.Read(k, ret);
 }
 
 bool CRecoveredSigsDb::GetRecoveredSigByHash(const uint256& hash, CRecoveredSig& ret)
 {
     auto k1 = std::make_tuple(std::string("rs_h"), hash);
     std::pair<uint8_t, uint256> k2;
-    if (!db.Read(k1, k2)) {
-        return false;
+    {
+        LOCK(cs);
+        if (!pendingWrites.Read(k1, k2)) {
+            return false;
+        }
     }
 
     return ReadRecoveredSig((Consensus::LLMQType)k2.first, k2.second, ret);
@@ -222,9 +211,12 @@ bool CRecoveredSigsDb::GetRecoveredSigById(Consensus::LLMQType llmqType, const u
 
 void CRecoveredSigsDb::WriteRecoveredSig(const llmq::CRecoveredSig& recSig)
 {
-    CDBBatch batch(db);
-
     uint32_t curTime = GetAdjustedTime();
+    auto signHash = CLLMQUtils::BuildSignHash(recSig);
+    auto hash = recSig.GetHash();
+
+    LOCK(cs);
+    auto& batch = pendingWrites;
 
     // we put these close to each other to leverage leveldb's key compaction
     // this way, the second key can be used for fast HasRecoveredSig checks while the first key stores the recSig
@@ -235,27 +227,24 @@ void CRecoveredSigsDb::WriteRecoveredSig(const llmq::CRecoveredSig& recSig)
     batch.Write(k2, curTime);
 
     // store by object hash
-    auto k3 = std::make_tuple(std::string("rs_h"), recSig.GetHash());
+    auto k3 = std::make_tuple(std::string("rs_h"), hash);
     batch.Write(k3, std::make_pair(recSig.llmqType, recSig.id));
 
     // store by signHash
-    auto signHash = CLLMQUtils::BuildSignHash(recSig);
     auto k4 = std::make_tuple(std::string("rs_s"), signHash);
     batch.Write(k4, (uint8_t)1);
 
-    // store by current time. Allows fast cleanup of old recSigs
+    // store by current time. Allows fast cleanup of old recSigs. The value holds everything needed to find the other
+    // keys, so that cleanup does not have to read the recSig itself
     auto k5 = std::make_tuple(std::string("rs_t"), (uint32_t)htobe32(curTime), recSig.llmqType, recSig.id);
-    batch.Write(k5, (uint8_t)1);
-
-    db.WriteBatch(batch);
+    batch.Write(k5, std::make_tuple(recSig.msgHash, hash, signHash));
 
-    {
-        int64_t t = GetTimeMillis();
+    hasSigForIdCache.insert(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.id), true);
+    hasSigForSessionCache.insert(signHash, true);
+    hasSigForHashCache.insert(hash, true);
 
-        LOCK(cs);
-        hasSigForIdCache.insert(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.id), true);
-        hasSigForSessionCache.insert(signHash, true);
-        hasSigForHashCache.insert(recSig.GetHash(), true);
+    if (pendingWrites.GetMemoryUsage() >= MAX_PENDING_WRITES_BYTES) {
+        CommitPendingWrites();
     }
 }
 
@@ -268,18 +257,8 @@ void CRecoveredSigsDb::RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType l
         return;
     }
 
-    auto signHash = CLLMQUtils::BuildSignHash(recSig);
-
-    auto k1 = std::make_tuple(std::string("rs_r"), recSig.llmqType, recSig.id);
-    auto k2 = std::make_tuple(std::string("rs_r"), recSig.llmqType, recSig.id, recSig.msgHash);
-    auto k3 = std::make_tuple(std::string("rs_h"), recSig.GetHash());
-    auto k4 = std::make_tuple(std::string("rs_s"), signHash);
-    batch.Erase(k1);
-    batch.Erase(k2);
-    batch.Erase(k3);
-    batch.Erase(k4);
-
     if (deleteTimeKey) {
+        auto k2 = std::make_tuple(std::string("rs_r"), recSig.llmqType, recSig.id, recSig.msgHash);
         CDataStream writeTimeDs(SER_DISK, CLIENT_VERSION);
         // TODO remove the size() == sizeof(uint32_t) in a future version (when we stop supporting upgrades from < 0.14.1)
         if (db.ReadDataStream(k2, writeTimeDs) && writeTimeDs.size() == sizeof(uint32_t)) {
@@ -290,14 +269,33 @@ void CRecoveredSigsDb::RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType l
         }
     }
 
-    hasSigForIdCache.erase(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.id));
+    RemoveRecoveredSig(batch, llmqType, id, recSig.msgHash, recSig.GetHash(), CLLMQUtils::BuildSignHash(recSig));
+}
+
+void CRecoveredSigsDb::RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash, const uint256& hash, const uint256& signHash)
+{
+    AssertLockHeld(cs);
+
+    auto k1 = std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id);
+    auto k2 = std::make_tuple(std::string("rs_r"), (uint8_t)llmqType, id, msgHash);
+    auto k3 = std::make_tuple(std::string("rs_h"), hash);
+    auto k4 = std::make_tuple(std::string("rs_s"), signHash);
+    batch.Erase(k1);
+    batch.Erase(k2);
+    batch.Erase(k3);
+    batch.Erase(k4);
+
+    hasSigForIdCache.erase(std::make_pair(llmqType, id));
     hasSigForSessionCache.erase(signHash);
-    hasSigForHashCache.erase(recSig.GetHash());
+    hasSigForHashCache.erase(hash);
 }
 
 void CRecoveredSigsDb::RemoveRecoveredSig(Consensus::LLMQType llmqType, const uint256& id)
 {
     LOCK(cs);
+    // the recSig and its time key might still be pending
+    CommitPendingWrites();
+
     CDBBatch batch(db);
     RemoveRecoveredSig(batch, llmqType, id, true);
     db.WriteBatch(batch);
@@ -305,14 +303,18 @@ void CRecoveredSigsDb::RemoveRecoveredSig(Consensus::LLMQType llmqType, const ui
 
 void CRecoveredSigsDb::CleanupOldRecoveredSigs(int64_t maxAge)
 {
+    CommitPendingWrites();
+
     std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
 
     auto start = std::make_tuple(std::string("rs_t"), (uint32_t)0, (uint8_t)0, uint256());
     uint32_t endTime = (uint32_t)(GetAdjustedTime() - maxAge);
     pcursor->Seek(start);
 
-    std::vector<std::pair<Consensus::LLMQType, uint256>> toDelete;
-    std::vector<decltype(start)> toDelete2;
+    // "rs_t" keys are ordered by time, so everything that needs to be deleted is in a single range at the beginning.
+    // Entries written by older versions don't have the msgHash/hash/signHash in their value and require reading the recSig
+    std::vector<std::pair<decltype(start), std::tuple<uint256, uint256, uint256>>> toDelete;
+    std::vector<decltype(start)> toDeleteOld;
 
     while (pcursor->Valid()) {
         decltype(start) k;
@@ -324,14 +326,18 @@ void CRecoveredSigsDb::CleanupOldRecoveredSigs(int64_t maxAge)
             break;
         }
 
-        toDelete.emplace_back((Consensus::LLMQType)std::get<2>(k), std::get<3>(k));
-        toDelete2.emplace_back(k);
+        std::tuple<uint256, uint256, uint256> v;
+        if (pcursor->GetValue(v)) {
+            toDelete.emplace_back(k, v);
+        } else {
+            toDeleteOld.emplace_back(k);
+        }
 
         pcursor->Next();
     }
     pcursor.reset();
 
-    if (toDelete.empty()) {
+    if (toDelete.empty() && toDeleteOld.empty()) {
         return;
     }
 
@@ -339,34 +345,54 @@ void CRecoveredSigsDb::CleanupOldRecoveredSigs(int64_t maxAge)
     {
         LOCK(cs);
         for (auto& e : toDelete) {
-            RemoveRecoveredSig(batch, e.first, e.second, false);
+            auto llmqType = (Consensus::LLMQType)std::get<2>(e.first);
+            RemoveRecoveredSig(batch, llmqType, std::get<3>(e.first), std::get<0>(e.second), std::get<1>(e.second), std::get<2>(e.second));
+            batch.Erase(e.first);
 
             if (batch.SizeEstimate() >= (1 << 24)) {
                 db.WriteBatch(batch);
                 batch.Clear();
             }
         }
-    }
+        for (auto& k : toDeleteOld) {
+            RemoveRecoveredSig(batch, (Consensus::LLMQType)std::get<2>(k), std::get<3>(k), false);
+            batch.Erase(k);
 
-    for (auto& e : toDelete2) {
-        batch.Erase(e);
+            if (batch.SizeEstimate() >= (1 << 24)) {
+                db.WriteBatch(batch);
+                batch.Clear();
+            }
+        }
     }
 
     db.WriteBatch(batch);
 
-    LogPrint("llmq", "CRecoveredSigsDb::%d -- deleted %d entries\n", __func__, toDelete.size());
+    LogPrint("llmq", "CRecoveredSigsDb::%d -- deleted %d entries\n", __func__, toDelete.size() + toDeleteOld.size());
+}
+
+void CRecoveredSigsDb::CommitPendingWrites()
+{
+    LOCK(cs);
+    if (pendingWrites.IsClean()) {
+        return;
+    }
+    pendingWrites.Commit();
+    db.WriteBatch(pendingBatch);
+    pendingBatch.Clear();
 }
 
 bool CRecoveredSigsDb::HasVotedOnId(Consensus::LLMQType llmqType, const uint256& id)
 {
     auto k = std::make_tuple(std::string("rs_v"), (uint8_t)llmqType, id);
-    return db.Exists(k);
+    LOCK(cs);
+    return pendingWrites.Exists(k);
 }
 
 bool CRecoveredSigsDb::GetVoteForId(Consensus::LLMQType llmqType, const uint256& id, uint256& msgHashRet)
 {
     auto k = std::make_tuple(std::string("rs_v"), (uint8_t)llmqType, id);
-    return db.Read(k, msgHashRet);
+    LOCK(cs);
+    return pendingWrites.Read(k, msgHashRet);
 }
 
 void CRecoveredSigsDb::WriteVoteForId(Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash)
@@ -374,15 +400,15 @@ void CRecoveredSigsDb::WriteVoteForId(Consensus::LLMQType llmqType, const uint25
     auto k1 = std::make_tuple(std::string("rs_v"), (uint8_t)llmqType, id);
     auto k2 = std::make_tuple(std::string("rs_vt"), (uint32_t)htobe32(GetAdjustedTime()), (uint8_t)llmqType, id);
 
-    CDBBatch batch(db);
-    batch.Write(k1, msgHash);
-    batch.Write(k2, (uint8_t)1);
-
-    db.WriteBatch(batch);
+    LOCK(cs);
+    pendingWrites.Write(k1, msgHash);
+    pendingWrites.Write(k2, (uint8_t)1);
 }
 
 void CRecoveredSigsDb::CleanupOldVotes(int64_t maxAge)
 {
+    CommitPendingWrites();
+
     std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
 
     auto start = std::make_tuple(std::string("rs_vt"), (uint32_t)0, (uint8_t)0, uint256());
@@ -427,6 +453,8 @@ void CRecoveredSigsDb::CleanupOldVotes(int64_t maxAge)
 CSigningManager::CSigningManager(CDBWrapper& llmqDb, bool fMemory) :
     db(llmqDb)
 {
+    GetRandBytes(validRecoveredSigsNonce.begin(), 32);
+    validRecoveredSigs.setup_bytes(VALID_RECOVERED_SIGS_CACHE_BYTES);
 }
 
 bool CSigningManager::AlreadyHave(const CInv& inv)
@@ -476,8 +504,18 @@ void CSigningManager::ProcessMessageRecoveredSig(CNode* pfrom, const CRecoveredS
     LogPrint("llmq", "CSigningManager::%s -- signHash=%s, id=%s, msgHash=%s, node=%d\n", __func__,
             CLLMQUtils::BuildSignHash(recoveredSig).ToString(), recoveredSig.id.ToString(), recoveredSig.msgHash.ToString(), pfrom->GetId());
 
-    LOCK(cs);
-    pendingRecoveredSigs[pfrom->id].emplace_back(recoveredSig);
+    {
+        LOCK(cs);
+        auto& pending = pendingRecoveredSigs[pfrom->id];
+        if (IsPriorityRequestId((Consensus::LLMQType)recoveredSig.llmqType, recoveredSig.id)) {
+            // verified in the next round, no matter how many other recovered sigs are pending
+            pending.emplace_front(recoveredSig);
+        } else {
+            pending.emplace_back(recoveredSig);
+        }
+    }
+    // pending recovered sigs are processed by the sig shares worker thread
+    quorumSigSharesManager->WakeupWorkerThread();
 }
 
 bool CSigningManager::PreVerifyRecoveredSig(NodeId nodeId, const CRecoveredSig& recoveredSig, bool& retBan)
@@ -578,10 +616,21 @@ void CSigningManager::ProcessPendingReconstructedRecoveredSigs()
         l = std::move(pendingReconstructedRecoveredSigs);
     }
     for (auto& p : l) {
+        // reconstructed sigs are known to be valid, so the same sig arriving through QSIGREC doesn't need verification
+        validRecoveredSigs.insert(GetValidRecoveredSigsCacheEntry(p.first));
         ProcessRecoveredSig(-1, p.first, p.second, *g_connman);
     }
 }
 
+uint256 CSigningManager::GetValidRecoveredSigsCacheEntry(const CRecoveredSig& recSig)
+{
+    CHashWriter hw(SER_GETHASH, 0);
+    hw << validRecoveredSigsNonce;
+    hw << CLLMQUtils::BuildSignHash(recSig);
+    hw << recSig.sig;
+    return hw.GetHash();
+}
+
 bool CSigningManager::ProcessPendingRecoveredSigs(CConnman& connman)
 {
     std::unordered_map<NodeId, std::list<CRecoveredSig>> recSigsByNode;
@@ -594,40 +643,124 @@ bool CSigningManager::ProcessPendingRecoveredSigs(CConnman& connman)
         return false;
     }
 
-    // It's ok to perform insecure batched verification here as we verify against the quorum public keys, which are not
-    // craftable by individual entities, making the rogue public key attack impossible
-    CBLSBatchVerifier<NodeId, uint256> batchVerifier(false, false);
-
-    size_t verifyCount = 0;
+    // The same recovered sig is usually received from many nodes at once, so we only verify each one once and then
+    // apply the result to all nodes that sent it. Recovered sigs for ids which already have one are not verified at
+    // all, as ProcessRecoveredSig would ignore them anyway.
+    std::unordered_map<uint256, const CRecoveredSig*, StaticSaltedHasher> uniqueRecSigs;
+    std::unordered_map<uint256, uint256, StaticSaltedHasher> cacheEntries;
+    std::unordered_set<uint256, StaticSaltedHasher> validRecSigs;
+    std::unordered_set<uint256, StaticSaltedHasher> invalidRecSigs;
+    std::set<NodeId> badNodes;
+    std::vector<uint256> alreadyKnown;
+
+    size_t cacheHits = 0;
     for (auto& p : recSigsByNode) {
         NodeId nodeId = p.first;
         auto& v = p.second;
 
-        for (auto& recSig : v) {
+        for (auto it = v.begin(); it != v.end();) {
+            auto& recSig = *it;
+            auto& hash = recSig.GetHash();
+
+            if (uniqueRecSigs.count(hash) || validRecSigs.count(hash)) {
+                ++it;
+                continue;
+            }
+            if (HasRecoveredSigForId((Consensus::LLMQType)recSig.llmqType, recSig.id)) {
+                alreadyKnown.emplace_back(hash);
+                it = v.erase(it);
+                continue;
+            }
+
             // we didn't verify the lazy signature until now
             if (!recSig.sig.Get().IsValid()) {
-                batchVerifier.badSources.emplace(nodeId);
+                badNodes.emplace(nodeId);
                 break;
             }
 
-            const auto& quorum = quorums.at(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.quorumHash));
-            batchVerifier.PushMessage(nodeId, recSig.GetHash(), CLLMQUtils::BuildSignHash(recSig), recSig.sig.Get(), quorum->qc.quorumPublicKey);
-            verifyCount++;
+            auto cacheEntry = GetValidRecoveredSigsCacheEntry(recSig);
+            if (validRecoveredSigs.contains(cacheEntry, false)) {
+                validRecSigs.emplace(hash);
+                cacheHits++;
+            } else {
+                uniqueRecSigs.emplace(hash, &recSig);
+                cacheEntries.emplace(hash, cacheEntry);
+            }
+            ++it;
         }
     }
 
+    if (!alreadyKnown.empty()) {
+        LOCK(cs_main);
+        for (auto& hash : alreadyKnown) {
+            connman.RemoveAskFor(hash);
+        }
+    }
+
+    std::vector<const CRecoveredSig*> toVerify;
+    toVerify.reserve(uniqueRecSigs.size());
+    for (auto& p : uniqueRecSigs) {
+        toVerify.emplace_back(p.second);
+    }
+
+    size_t maxJobSize = std::max(MIN_RECOVERED_SIGS_PER_VERIFY_JOB, toVerify.size() / std::max(1, GetNumCores()));
+    size_t jobCount = (toVerify.size() + maxJobSize - 1) / maxJobSize;
+    std::vector<std::set<uint256>> jobBadRecSigs(jobCount);
+
+    auto verifyJobs = [&](size_t start, size_t count) {
+        for (size_t i = start; i < start + count; i++) {
+            // It's ok to perform insecure batched verification here as we verify against the quorum public keys, which
+            // are not craftable by individual entities, making the rogue public key attack impossible
+            // Each unique recovered sig is its own source, so that only invalid ones end up in badSources
+            CBLSBatchVerifier<uint256, uint256> batchVerifier(false, false, 0, blsWorker);
+
+            size_t end = std::min(toVerify.size(), (i + 1) * maxJobSize);
+            for (size_t j = i * maxJobSize; j < end; j++) {
+                auto& recSig = *toVerify[j];
+                const auto& quorum = quorums.at(std::make_pair((Consensus::LLMQType)recSig.llmqType, recSig.quorumHash));
+                batchVerifier.PushMessage(recSig.GetHash(), recSig.GetHash(), CLLMQUtils::BuildSignHash(recSig), recSig.sig.Get(), quorum->qc.quorumPublicKey);
+            }
+            batchVerifier.Verify();
+            jobBadRecSigs[i] = std::move(batchVerifier.badSources);
+        }
+    };
+
     cxxtimer::Timer verifyTimer(true);
-    batchVerifier.Verify();
+    if (blsWorker && jobCount > 1) {
+        blsWorker->ParallelForBatches(jobCount, 1, verifyJobs);
+    } else {
+        verifyJobs(0, jobCount);
+    }
     verifyTimer.stop();
 
-    LogPrint("llmq", "CSigningManager::%s -- verified recovered sig(s). count=%d, vt=%d, nodes=%d\n", __func__, verifyCount, verifyTimer.count(), recSigsByNode.size());
+    for (auto& s : jobBadRecSigs) {
+        invalidRecSigs.insert(s.begin(), s.end());
+    }
+    for (auto& p : uniqueRecSigs) {
+        if (!invalidRecSigs.count(p.first)) {
+            validRecSigs.emplace(p.first);
+            validRecoveredSigs.insert(cacheEntries.at(p.first));
+        }
+    }
+
+    LogPrint("llmq", "CSigningManager::%s -- verified recovered sig(s). count=%d, cacheHits=%d, jobs=%d, vt=%d, nodes=%d\n", __func__,
+             toVerify.size(), cacheHits, jobCount, verifyTimer.count(), recSigsByNode.size());
+
+    for (auto& p : recSigsByNode) {
+        for (auto& recSig : p.second) {
+            if (invalidRecSigs.count(recSig.GetHash())) {
+                badNodes.emplace(p.first);
+                break;
+            }
+        }
+    }
 
     std::unordered_set<uint256, StaticSaltedHasher> processed;
     for (auto& p : recSigsByNode) {
         NodeId nodeId = p.first;
         auto& v = p.second;
 
-        if (batchVerifier.badSources.count(nodeId)) {
+        if (badNodes.count(nodeId)) {
             LOCK(cs_main);
             LogPrintf("CSigningManager::%s -- invalid recSig from other node, banning peer=%d\n", __func__, nodeId);
             Misbehaving(nodeId, 100);
@@ -635,7 +768,7 @@ bool CSigningManager::ProcessPendingRecoveredSigs(CConnman& connman)
         }
 
         for (auto& recSig : v) {
-            if (!processed.emplace(recSig.GetHash()).second) {
+            if (!validRecSigs.count(recSig.GetHash()) || !processed.emplace(recSig.GetHash()).second) {
                 continue;
             }
 
@@ -706,8 +839,11 @@ void CSigningManager::ProcessRecoveredSig(NodeId nodeId, const CRecoveredSig& re
 
 void CSigningManager::PushReconstructedRecoveredSig(const llmq::CRecoveredSig& recoveredSig, const llmq::CQuorumCPtr& quorum)
 {
-    LOCK(cs);
-    pendingReconstructedRecoveredSigs.emplace_back(recoveredSig, quorum);
+    {
+        LOCK(cs);
+        pendingReconstructedRecoveredSigs.emplace_back(recoveredSig, quorum);
+    }
+    quorumSigSharesManager->WakeupWorkerThread();
 }
 
 void CSigningManager::RemoveRecoveredSig(Consensus::LLMQType llmqType, const uint256& id)
@@ -717,6 +853,9 @@ void CSigningManager::RemoveRecoveredSig(Consensus::LLMQType llmqType, const uin
 
 void CSigningManager::Cleanup()
 {
+    // recovered sigs and votes are written in one batch per worker iteration
+    db.CommitPendingWrites();
+
     int64_t now = GetTimeMillis();
     if (now - lastCleanupTime < 5000) {
         return;
@@ -727,6 +866,18 @@ void CSigningManager::Cleanup()
     db.CleanupOldRecoveredSigs(maxAge);
     db.CleanupOldVotes(maxAge);
 
+    {
+        LOCK(cs);
+        int64_t curTime = GetAdjustedTime();
+        for (auto it = priorityRequestIds.begin(); it != priorityRequestIds.end(); ) {
+            if (curTime - it->second >= PRIORITY_REQUEST_ID_TIMEOUT) {
+                it = priorityRequestIds.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
     lastCleanupTime = GetTimeMillis();
 }
 
@@ -812,6 +963,18 @@ bool CSigningManager::AsyncSignIfMember(Consensus::LLMQType llmqType, const uint
     return true;
 }
 
+void CSigningManager::AddPriorityRequestId(Consensus::LLMQType llmqType, const uint256& id)
+{
+    LOCK(cs);
+    priorityRequestIds[std::make_pair(llmqType, id)] = GetAdjustedTime();
+}
+
+bool CSigningManager::IsPriorityRequestId(Consensus::LLMQType llmqType, const uint256& id)
+{
+    LOCK(cs);
+    return priorityRequestIds.count(std::make_pair(llmqType, id)) != 0;
+}
+
 bool CSigningManager::HasRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash)
 {
     return db.HasRecoveredSig(llmqType, id, msgHash);
@@ -9,6 +9,8 @@
 
 #include "net.h"
 #include "chainparams.h"
+#include "cuckoocache.h"
+#include "dbwrapper.h"
 #include "saltedhasher.h"
 #include "univalue.h"
 #include "unordered_lru_cache.h"
@@ -64,15 +66,22 @@ public:
 class CRecoveredSigsDb
 {
 private:
+    static const size_t MAX_PENDING_WRITES_BYTES = 4 * 1024 * 1024;
+
     CDBWrapper& db;
 
     CCriticalSection cs;
+    // Recovered sigs and votes are first written into this transaction, which is then committed to the DB in a single
+    // batch by CommitPendingWrites. Reads go through the transaction so that they see pending writes.
+    CDBBatch pendingBatch;
+    CDBTransaction<CDBWrapper, CDBBatch> pendingWrites;
     unordered_lru_cache<std::pair<Consensus::LLMQType, uint256>, bool, StaticSaltedHasher, 30000> hasSigForIdCache;
     unordered_lru_cache<uint256, bool, StaticSaltedHasher, 30000> hasSigForSessionCache;
     unordered_lru_cache<uint256, bool, StaticSaltedHasher, 30000> hasSigForHashCache;
 
 public:
     CRecoveredSigsDb(CDBWrapper& _db);
+    ~CRecoveredSigsDb();
 
     void ConvertInvalidTimeKeys();
     void AddVoteTimeKeys();
@@ -88,6 +97,9 @@ public:
 
     void CleanupOldRecoveredSigs(int64_t maxAge);
 
+    // Writes all recovered sigs and votes which were written since the last call in a single batch
+    void CommitPendingWrites();
+
     // votes are removed when the recovered sig is written to the db
     bool HasVotedOnId(Consensus::LLMQType llmqType, const uint256& id);
     bool GetVoteForId(Consensus::LLMQType llmqType, const uint256& id, uint256& msgHashRet);
@@ -98,6 +110,7 @@ public:
 private:
     bool ReadRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, CRecoveredSig& ret);
     void RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType llmqType, const uint256& id, bool deleteTimeKey);
+    void RemoveRecoveredSig(CDBBatch& batch, Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash, const uint256& hash, const uint256& signHash);
 };
 
 class CRecoveredSigsListener
@@ -108,6 +121,23 @@ public:
     virtual void HandleNewRecoveredSig(const CRecoveredSig& recoveredSig) = 0;
 };
 
+/**
+ * Entries of the valid recovered sigs cache are already nonced hashes, so we can directly use their bits as hashes
+ * for the cuckoo cache. This is the same as done in the ECDSA signature cache.
+ */
+class CRecoveredSigCacheHasher
+{
+public:
+    template <uint8_t hash_select>
+    uint32_t operator()(const uint256& key) const
+    {
+        static_assert(hash_select < 8, "CRecoveredSigCacheHasher only has 8 hashes available.");
+        uint32_t u;
+        std::memcpy(&u, key.begin() + 4 * hash_select, 4);
+        return u;
+    }
+};
+
 class CSigningManager
 {
     friend class CSigSharesManager;
@@ -118,6 +148,13 @@ class CSigningManager
     // which are not 100% at the chain tip.
     static const int SIGN_HEIGHT_OFFSET = 8;
 
+    // size of the cache for recovered sigs which were already verified
+    static const size_t VALID_RECOVERED_SIGS_CACHE_BYTES = 1 << 20;
+    // verification of unique recovered sigs is split into jobs of at least this size
+    static const size_t MIN_RECOVERED_SIGS_PER_VERIFY_JOB = 8;
+    // priority request ids are forgotten after this many seconds
+    static const int64_t PRIORITY_REQUEST_ID_TIMEOUT = 10 * 60;
+
 private:
     CCriticalSection cs;
 
@@ -130,8 +167,17 @@ private:
     // must be protected by cs
     FastRandomContext rnd;
 
+    // Recovered sigs which were verified already. Entries are hash(nonce || signHash || sig). Only accessed from the
+    // worker thread of CSigSharesManager
+    uint256 validRecoveredSigsNonce;
+    CuckooCache::cache<uint256, CRecoveredSigCacheHasher> validRecoveredSigs;
+
     int64_t lastCleanupTime{0};
 
+    // Request ids (and the time they were added) for which signing, sig share verification, sending and recovery is
+    // done before all other pending work
+    std::unordered_map<std::pair<Consensus::LLMQType, uint256>, int64_t, StaticSaltedHasher> priorityRequestIds;
+
     std::vector<CRecoveredSigsListener*> recoveredSigsListeners;
 
 public:
@@ -158,6 +204,7 @@ private:
             std::unordered_map<NodeId, std::list<CRecoveredSig>>& retSigShares,
             std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher>& retQuorums);
     void ProcessPendingReconstructedRecoveredSigs();
+    uint256 GetValidRecoveredSigsCacheEntry(const CRecoveredSig& recSig);
     bool ProcessPendingRecoveredSigs(CConnman& connman); // called from the worker thread of CSigSharesManager
     void ProcessRecoveredSig(NodeId nodeId, const CRecoveredSig& recoveredSig, const CQuorumCPtr& quorum, CConnman& connman);
     void Cleanup(); // called from the worker thread of CSigSharesManager
@@ -168,6 +215,11 @@ public:
     void UnregisterRecoveredSigsListener(CRecoveredSigsListener* l);
 
     bool AsyncSignIfMember(Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash, bool allowReSign = false);
+
+    // Marks a request id as latency critical, so that it never waits behind other signing sessions. This is used by
+    // ChainLocks, which must not be delayed by large amounts of InstantSend sig shares
+    void AddPriorityRequestId(Consensus::LLMQType llmqType, const uint256& id);
+    bool IsPriorityRequestId(Consensus::LLMQType llmqType, const uint256& id);
     bool HasRecoveredSig(Consensus::LLMQType llmqType, const uint256& id, const uint256& msgHash);
     bool HasRecoveredSigForId(Consensus::LLMQType llmqType, const uint256& id);
     bool HasRecoveredSigForSession(const uint256& signHash);
@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "quorums_signing.h"
+#include "quorums_init.h"
 #include "quorums_signing_shares.h"
 #include "quorums_utils.h"
 
@@ -34,16 +35,12 @@ std::string CSigSesAnn::ToString() const
 
 void CSigSharesInv::Merge(const CSigSharesInv& inv2)
 {
-    for (size_t i = 0; i < inv.size(); i++) {
-        if (inv2.inv[i]) {
-            inv[i] = inv2.inv[i];
-        }
-    }
+    inv |= inv2.inv;
 }
 
 size_t CSigSharesInv::CountSet() const
 {
-    return (size_t)std::count(inv.begin(), inv.end(), true);
+    return inv.count();
 }
 
 std::string CSigSharesInv::ToString() const
@@ -84,9 +81,7 @@ void CSigSharesInv::Set(uint16_t quorumMember, bool v)
 
 void CSigSharesInv::SetAll(bool v)
 {
-    for (size_t i = 0; i < inv.size(); i++) {
-        inv[i] = v;
-    }
+    inv.SetAll(v);
 }
 
 std::string CBatchedSigShares::ToInvString() const
@@ -228,6 +223,16 @@ void CSigSharesManager::UnregisterAsRecoveredSigsListener()
 void CSigSharesManager::InterruptWorkerThread()
 {
     workInterrupt();
+    WakeupWorkerThread();
+}
+
+void CSigSharesManager::WakeupWorkerThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(workMutex);
+        workPending = true;
+    }
+    workCond.notify_one();
 }
 
 void CSigSharesManager::ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman)
@@ -297,7 +302,12 @@ void CSigSharesManager::ProcessMessage(CNode* pfrom, const std::string& strComma
                 return;
             }
         }
+    } else {
+        return;
     }
+
+    // announcements and requests need to be answered and new sig shares need to be verified
+    WakeupWorkerThread();
 }
 
 bool CSigSharesManager::ProcessMessageSigSesAnn(CNode* pfrom, const CSigSesAnn& ann, CConnman& connman)
@@ -378,6 +388,10 @@ bool CSigSharesManager::ProcessMessageSigSharesInv(CNode* pfrom, const CSigShare
     }
     session->announced.Merge(inv);
     session->knows.Merge(inv);
+    if (quorumSigningManager->IsPriorityRequestId(sessionInfo.llmqType, sessionInfo.id)) {
+        // request the announced shares right away
+        prioritySendPending = true;
+    }
     return true;
 }
 
@@ -408,6 +422,10 @@ bool CSigSharesManager::ProcessMessageGetSigShares(CNode* pfrom, const CSigShare
     }
     session->requested.Merge(inv);
     session->knows.Merge(inv);
+    if (quorumSigningManager->IsPriorityRequestId(sessionInfo.llmqType, sessionInfo.id)) {
+        // answer the request right away
+        prioritySendPending = true;
+    }
     return true;
 }
 
@@ -458,11 +476,18 @@ bool CSigSharesManager::ProcessMessageBatchedSigShares(CNode* pfrom, const CBatc
         return true;
     }
 
+    int64_t nTimeReceived = GetTimeMicros();
+    bool isPriority = quorumSigningManager->IsPriorityRequestId(sessionInfo.llmqType, sessionInfo.id);
+
     LOCK(cs);
     auto& nodeState = nodeStates[pfrom->id];
     for (auto& s : sigShares) {
+        s.nTimeReceived = nTimeReceived;
         nodeState.pendingIncomingSigShares.Add(s.GetKey(), s);
     }
+    if (isPriority) {
+        pendingPrioritySignHashes.emplace(sessionInfo.signHash);
+    }
     return true;
 }
 
@@ -509,6 +534,7 @@ bool CSigSharesManager::PreVerifyBatchedSigShares(NodeId nodeId, const CSigShare
 }
 
 void CSigSharesManager::CollectPendingSigSharesToVerify(
+        bool priorityOnly,
         size_t maxUniqueSessions,
         std::unordered_map<NodeId, std::vector<CSigShare>>& retSigShares,
         std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher>& retQuorums)
@@ -519,29 +545,46 @@ void CSigSharesManager::CollectPendingSigSharesToVerify(
             return;
         }
 
-        // This will iterate node states in random order and pick one sig share at a time. This avoids processing
-        // of large batches at once from the same node while other nodes also provided shares. If we wouldn't do this,
-        // other nodes would be able to poison us with a large batch with N-1 valid shares and the last one being
-        // invalid, making batch verification fail and revert to per-share verification, which in turn would slow down
-        // the whole verification process
-
-        std::unordered_set<std::pair<NodeId, uint256>, StaticSaltedHasher> uniqueSignHashes;
-        CLLMQUtils::IterateNodesRandom(nodeStates, [&]() {
-            return uniqueSignHashes.size() < maxUniqueSessions;
-        }, [&](NodeId nodeId, CSigSharesNodeState& ns) {
-            if (ns.pendingIncomingSigShares.Empty()) {
-                return false;
+        if (priorityOnly) {
+            // Priority sessions are rare and small compared to everything else, so all of their pending shares are
+            // verified at once. maxUniqueSessions is not applied here
+            for (auto& signHash : pendingPrioritySignHashes) {
+                for (auto& p : nodeStates) {
+                    auto& ns = p.second;
+                    ns.pendingIncomingSigShares.ForEachForSignHash(signHash, [&](const SigShareKey& k, const CSigShare& sigShare) {
+                        if (!this->sigShares.Has(k)) {
+                            retSigShares[p.first].emplace_back(sigShare);
+                        }
+                    });
+                    ns.pendingIncomingSigShares.EraseAllForSignHash(signHash);
+                }
             }
-            auto& sigShare = *ns.pendingIncomingSigShares.GetFirst();
+            pendingPrioritySignHashes.clear();
+        } else {
+            // This will iterate node states in random order and pick one sig share at a time. This avoids processing
+            // of large batches at once from the same node while other nodes also provided shares. If we wouldn't do this,
+            // other nodes would be able to poison us with a large batch with N-1 valid shares and the last one being
+            // invalid, making batch verification fail and revert to per-share verification, which in turn would slow down
+            // the whole verification process
+
+            std::unordered_set<std::pair<NodeId, uint256>, StaticSaltedHasher> uniqueSignHashes;
+            CLLMQUtils::IterateNodesRandom(nodeStates, [&]() {
+                return uniqueSignHashes.size() < maxUniqueSessions;
+            }, [&](NodeId nodeId, CSigSharesNodeState& ns) {
+                if (ns.pendingIncomingSigShares.Empty()) {
+                    return false;
+                }
+                auto& sigShare = *ns.pendingIncomingSigShares.GetFirst();
 
-            bool alreadyHave = this->sigShares.Has(sigShare.GetKey());
-            if (!alreadyHave) {
-                uniqueSignHashes.emplace(nodeId, sigShare.GetSignHash());
-                retSigShares[nodeId].emplace_back(sigShare);
-            }
-            ns.pendingIncomingSigShares.Erase(sigShare.GetKey());
-            return !ns.pendingIncomingSigShares.Empty();
-        }, rnd);
+                bool alreadyHave = this->sigShares.Has(sigShare.GetKey());
+                if (!alreadyHave) {
+                    uniqueSignHashes.emplace(nodeId, sigShare.GetSignHash());
+                    retSigShares[nodeId].emplace_back(sigShare);
+                }
+                ns.pendingIncomingSigShares.Erase(sigShare.GetKey());
+                return !ns.pendingIncomingSigShares.Empty();
+            }, rnd);
+        }
 
         if (retSigShares.empty()) {
             return;
@@ -570,19 +613,35 @@ void CSigSharesManager::CollectPendingSigSharesToVerify(
     }
 }
 
-bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman)
+size_t CSigSharesManager::GetMaxUniqueSessionsToVerify()
+{
+    size_t pendingCount = 0;
+    {
+        LOCK(cs);
+        for (const auto& p : nodeStates) {
+            pendingCount += p.second.pendingIncomingSigShares.Size();
+        }
+    }
+
+    // Verify more at once when shares are piling up. Bigger batches need fewer pairings per share and are split
+    // across the BLS worker threads, while small batches keep the latency low when there is no backlog
+    return std::min(std::max(MIN_UNIQUE_SESSIONS_TO_VERIFY, pendingCount / 4), MAX_UNIQUE_SESSIONS_TO_VERIFY);
+}
+
+bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman, bool priorityOnly)
 {
     std::unordered_map<NodeId, std::vector<CSigShare>> sigSharesByNodes;
     std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher> quorums;
 
-    CollectPendingSigSharesToVerify(32, sigSharesByNodes, quorums);
+    CollectPendingSigSharesToVerify(priorityOnly, priorityOnly ? 0 : GetMaxUniqueSessionsToVerify(), sigSharesByNodes, quorums);
     if (sigSharesByNodes.empty()) {
         return false;
     }
 
-    // It's ok to perform insecure batched verification here as we verify against the quorum public key shares,
-    // which are not craftable by individual entities, making the rogue public key attack impossible
-    CBLSBatchVerifier<NodeId, SigShareKey> batchVerifier(false, true);
+    // Shares for the same sign hash only need a single pairing for the message when verified in the same batch, so
+    // we group them by sign hash. The groups are then split into jobs which are verified on the BLS worker threads
+    std::unordered_map<uint256, std::vector<std::pair<NodeId, const CSigShare*>>, StaticSaltedHasher> bySignHash;
+    std::set<NodeId> badSources;
 
     size_t verifyCount = 0;
     for (auto& p : sigSharesByNodes) {
@@ -598,36 +657,77 @@ bool CSigSharesManager::ProcessPendingSigShares(CConnman& connman)
             // deserialization in the message thread
             if (!sigShare.sigShare.Get().IsValid()) {
                 BanNode(nodeId);
+                badSources.emplace(nodeId);
                 // don't process any additional shares from this node
                 break;
             }
 
-            auto quorum = quorums.at(std::make_pair((Consensus::LLMQType)sigShare.llmqType, sigShare.quorumHash));
-            auto pubKeyShare = quorum->GetPubKeyShare(sigShare.quorumMember);
-
-            if (!pubKeyShare.IsValid()) {
-                // this should really not happen (we already ensured we have the quorum vvec,
-                // so we should also be able to create all pubkey shares)
-                LogPrintf("CSigSharesManager::%s -- pubKeyShare is invalid, which should not be possible here");
-                assert(false);
-            }
-
-            batchVerifier.PushMessage(nodeId, sigShare.GetKey(), sigShare.GetSignHash(), sigShare.sigShare.Get(), pubKeyShare);
+            bySignHash[sigShare.GetSignHash()].emplace_back(nodeId, &sigShare);
             verifyCount++;
         }
     }
 
+    size_t maxJobSize = std::max(MIN_SIGSHARES_PER_VERIFY_JOB, verifyCount / std::max(1, GetNumCores()));
+    std::vector<std::vector<std::pair<NodeId, const CSigShare*>>> jobs;
+    for (auto& p : bySignHash) {
+        auto& v = p.second;
+        for (size_t i = 0; i < v.size(); i += maxJobSize) {
+            jobs.emplace_back(v.begin() + i, v.begin() + std::min(v.size(), i + maxJobSize));
+        }
+    }
+    std::vector<std::set<NodeId>> jobBadSources(jobs.size());
+
+    auto verifyJobs = [&](size_t start, size_t count) {
+        for (size_t i = start; i < start + count; i++) {
+            // It's ok to perform insecure batched verification here as we verify against the quorum public key shares,
+            // which are not craftable by individual entities, making the rogue public key attack impossible
+            CBLSBatchVerifier<NodeId, SigShareKey> batchVerifier(false, true, 0, blsWorker);
+
+            for (auto& p : jobs[i]) {
+                auto& sigShare = *p.second;
+                auto quorum = quorums.at(std::make_pair((Consensus::LLMQType)sigShare.llmqType, sigShare.quorumHash));
+                auto pubKeyShare = quorum->GetPubKeyShare(sigShare.quorumMember);
+
+                if (!pubKeyShare.IsValid()) {
+                    // this should really not happen (we already ensured we have the quorum vvec,
+                    // so we should also be able to create all pubkey shares)
+                    LogPrintf("CSigSharesManager::%s -- pubKeyShare is invalid, which should not be possible here");
+                    assert(false);
+                }
+
+                batchVerifier.PushMessage(p.first, sigShare.GetKey(), sigShare.GetSignHash(), sigShare.sigShare.Get(), pubKeyShare);
+            }
+            batchVerifier.Verify();
+            jobBadSources[i] = std::move(batchVerifier.badSources);
+        }
+    };
+
     cxxtimer::Timer verifyTimer(true);
-    batchVerifier.Verify();
+    if (blsWorker && jobs.size() > 1) {
+        blsWorker->ParallelForBatches(jobs.size(), 1, verifyJobs);
+    } else {
+        verifyJobs(0, jobs.size());
+    }
     verifyTimer.stop();
 
-    LogPrint("llmq-sigs", "CSigSharesManager::%s -- verified sig shares. count=%d, vt=%d, nodes=%d\n", __func__, verifyCount, verifyTimer.count(), sigSharesByNodes.size());
+    for (auto& s : jobBadSources) {
+        badSources.insert(s.begin(), s.end());
+    }
+
+    int64_t nTimeVerified = GetTimeMicros();
+    for (auto& p : sigSharesByNodes) {
+        for (auto& sigShare : p.second) {
+            latencyStats.receiveToVerify.Add(nTimeVerified - sigShare.nTimeReceived);
+        }
+    }
+
+    LogPrint("llmq-sigs", "CSigSharesManager::%s -- verified sig shares. count=%d, jobs=%d, vt=%d, nodes=%d, priority=%d\n", __func__, verifyCount, jobs.size(), verifyTimer.count(), sigSharesByNodes.size(), priorityOnly);
 
     for (auto& p : sigSharesByNodes) {
         auto nodeId = p.first;
         auto& v = p.second;
 
-        if (batchVerifier.badSources.count(nodeId)) {
+        if (badSources.count(nodeId)) {
             LogPrintf("CSigSharesManager::%s -- invalid sig shares from other node, banning peer=%d\n",
                      __func__, nodeId);
             // this will also cause re-requesting of the shares that were sent by this node
@@ -677,6 +777,8 @@ void CSigSharesManager::ProcessSigShare(NodeId nodeId, const CSigShare& sigShare
         return;
     }
 
+    bool isPriority = quorumSigningManager->IsPriorityRequestId(llmqType, sigShare.id);
+
     {
         LOCK(cs);
 
@@ -684,9 +786,13 @@ void CSigSharesManager::ProcessSigShare(NodeId nodeId, const CSigShare& sigShare
             return;
         }
         sigSharesToAnnounce.Add(sigShare.GetKey(), true);
+        if (isPriority) {
+            prioritySendPending = true;
+        }
 
         // Update the time we've seen the last sigShare
         timeSeenForSessions[sigShare.GetSignHash()] = GetAdjustedTime();
+        timeFirstShareForSessions.emplace(sigShare.GetSignHash(), GetTimeMicros());
 
         if (!quorumNodes.empty()) {
             // don't announce and wait for other nodes to request this share and directly send it to them
@@ -717,6 +823,9 @@ void CSigSharesManager::TryRecoverSig(const CQuorumCPtr& quorum, const uint256&
         return;
     }
 
+    int64_t nTimeStart = GetTimeMicros();
+    int64_t nTimeFirstShare = 0;
+
     std::vector<CBLSSignature> sigSharesForRecovery;
     std::vector<CBLSId> idsForRecovery;
     {
@@ -725,18 +834,23 @@ void CSigSharesManager::TryRecoverSig(const CQuorumCPtr& quorum, const uint256&
         auto k = std::make_pair(quorum->params.type, id);
 
         auto signHash = CLLMQUtils::BuildSignHash(quorum->params.type, quorum->qc.quorumHash, id, msgHash);
-        auto sigShares = this->sigShares.GetAllForSignHash(signHash);
-        if (!sigShares) {
+        if (this->sigShares.CountForSignHash(signHash) < (size_t)quorum->params.threshold) {
             return;
         }
 
+        auto timeIt = timeFirstShareForSessions.find(signHash);
+        if (timeIt != timeFirstShareForSessions.end()) {
+            nTimeFirstShare = timeIt->second;
+        }
+
         sigSharesForRecovery.reserve((size_t) quorum->params.threshold);
         idsForRecovery.reserve((size_t) quorum->params.threshold);
-        for (auto it = sigShares->begin(); it != sigShares->end() && sigSharesForRecovery.size() < quorum->params.threshold; ++it) {
-            auto& sigShare = it->second;
-            sigSharesForRecovery.emplace_back(sigShare.sigShare.Get());
-            idsForRecovery.emplace_back(CBLSId::FromHash(quorum->members[sigShare.quorumMember]->proTxHash));
-        }
+        this->sigShares.ForEachForSignHash(signHash, [&](const SigShareKey& k, const CSigShare& sigShare) {
+            if (sigSharesForRecovery.size() < quorum->params.threshold) {
+                sigSharesForRecovery.emplace_back(sigShare.sigShare.Get());
+                idsForRecovery.emplace_back(CBLSId::FromHash(quorum->members[sigShare.quorumMember]->proTxHash));
+            }
+        });
 
         // check if we can recover the final signature
         if (sigSharesForRecovery.size() < quorum->params.threshold) {
@@ -779,6 +893,12 @@ void CSigSharesManager::TryRecoverSig(const CQuorumCPtr& quorum, const uint256&
     }
 
     quorumSigningManager->ProcessRecoveredSig(-1, rs, quorum, connman);
+
+    int64_t nTimeRecovered = GetTimeMicros();
+    latencyStats.verifyToRecover.Add(nTimeRecovered - nTimeStart);
+    if (nTimeFirstShare != 0) {
+        latencyStats.firstShareToRecover.Add(nTimeRecovered - nTimeFirstShare);
+    }
 }
 
 void CSigSharesManager::CollectSigSharesToRequest(std::unordered_map<NodeId, std::unordered_map<uint256, CSigSharesInv, StaticSaltedHasher>>& sigSharesToRequest)
@@ -1224,18 +1344,20 @@ void CSigSharesManager::Cleanup()
             size_t count = sigShares.CountForSignHash(signHash);
 
             if (count > 0) {
-                auto m = sigShares.GetAllForSignHash(signHash);
-                assert(m);
-
-                auto& oneSigShare = m->begin()->second;
+                const CSigShare* oneSigShare = nullptr;
+                sigShares.ForEachForSignHash(signHash, [&](const SigShareKey& k, const CSigShare& sigShare) {
+                    if (!oneSigShare) {
+                        oneSigShare = &sigShare;
+                    }
+                });
 
                 std::string strMissingMembers;
                 if (LogAcceptCategory("llmq")) {
-                    auto quorumIt = quorums.find(std::make_pair((Consensus::LLMQType)oneSigShare.llmqType, oneSigShare.quorumHash));
+                    auto quorumIt = quorums.find(std::make_pair((Consensus::LLMQType)oneSigShare->llmqType, oneSigShare->quorumHash));
                     if (quorumIt != quorums.end()) {
                         auto& quorum = quorumIt->second;
                         for (size_t i = 0; i < quorum->members.size(); i++) {
-                            if (!m->count((uint16_t)i)) {
+                            if (!sigShares.Has(std::make_pair(signHash, (uint16_t)i))) {
                                 auto& dmn = quorum->members[i];
                                 strMissingMembers += strprintf("\n  %s", dmn->proTxHash.ToString());
                             }
@@ -1244,7 +1366,7 @@ void CSigSharesManager::Cleanup()
                 }
 
                 LogPrint("llmq-sigs", "CSigSharesManager::%s -- signing session timed out. signHash=%s, id=%s, msgHash=%s, sigShareCount=%d, missingMembers=%s\n", __func__,
-                          signHash.ToString(), oneSigShare.id.ToString(), oneSigShare.msgHash.ToString(), count, strMissingMembers);
+                          signHash.ToString(), oneSigShare->id.ToString(), oneSigShare->msgHash.ToString(), count, strMissingMembers);
             } else {
                 LogPrint("llmq-sigs", "CSigSharesManager::%s -- signing session timed out. signHash=%s, sigShareCount=%d\n", __func__,
                           signHash.ToString(), count);
@@ -1287,6 +1409,7 @@ void CSigSharesManager::RemoveSigSharesForSession(const uint256& signHash)
     sigSharesToAnnounce.EraseAllForSignHash(signHash);
     sigShares.EraseAllForSignHash(signHash);
     timeSeenForSessions.erase(signHash);
+    timeFirstShareForSessions.erase(signHash);
 }
 
 void CSigSharesManager::RemoveBannedNodeStates()
@@ -1335,9 +1458,19 @@ void CSigSharesManager::BanNode(NodeId nodeId)
     nodeState.banned = true;
 }
 
+// Waits until WakeupWorkerThread() is called or maxWait has passed. Returns false when the thread got interrupted
+bool CSigSharesManager::WaitForWork(std::chrono::milliseconds maxWait, bool& retWokenUp)
+{
+    std::unique_lock<std::mutex> lock(workMutex);
+    retWokenUp = workCond.wait_for(lock, maxWait, [this]() { return workPending || workInterrupt; });
+    workPending = false;
+    return !workInterrupt;
+}
+
 void CSigSharesManager::WorkThreadMain()
 {
     int64_t lastSendTime = 0;
+    bool wokenUp = false;
 
     while (!workInterrupt) {
         if (!quorumSigningManager || !g_connman) {
@@ -1350,11 +1483,28 @@ void CSigSharesManager::WorkThreadMain()
         bool didWork = false;
 
         RemoveBannedNodeStates();
-        didWork |= quorumSigningManager->ProcessPendingRecoveredSigs(*g_connman);
-        didWork |= ProcessPendingSigShares(*g_connman);
-        didWork |= SignPendingSigShares();
 
-        if (GetTimeMillis() - lastSendTime > 100) {
+        // Priority sessions (ChainLocks) are signed, verified and recovered first and their messages are sent out
+        // right away, so that they never wait behind large batches of InstantSend sig shares
+        didWork |= SignPendingSigShares(true);
+        didWork |= ProcessPendingSigShares(*g_connman, true);
+        if (prioritySendPending.exchange(false)) {
+            SendMessages();
+            lastSendTime = GetTimeMillis();
+        }
+
+        didWork |= quorumSigningManager->ProcessPendingRecoveredSigs(*g_connman);
+        didWork |= ProcessPendingSigShares(*g_connman, false);
+        didWork |= SignPendingSigShares(false);
+
+        // Small batches are sent immediately, as every round of waiting adds to the time it takes to recover
+        // signatures. Bigger batches are collected for up to SEND_INTERVAL_MS, so that they are merged into fewer messages
+        bool sendNow = GetTimeMillis() - lastSendTime > SEND_INTERVAL_MS;
+        if (!sendNow && (didWork || wokenUp)) {
+            LOCK(cs);
+            sendNow = sigSharesToAnnounce.Size() <= MAX_IMMEDIATE_SEND_SHARES;
+        }
+        if (sendNow) {
             SendMessages();
             lastSendTime = GetTimeMillis();
         }
@@ -1362,9 +1512,10 @@ void CSigSharesManager::WorkThreadMain()
         Cleanup();
         quorumSigningManager->Cleanup();
 
-        // TODO Wakeup when pending signing is needed?
+        wokenUp = false;
         if (!didWork) {
-            if (!workInterrupt.sleep_for(std::chrono::milliseconds(100))) {
+            // we still wake up regularly to send batched messages, re-request timed out shares and to do cleanups
+            if (!WaitForWork(std::chrono::milliseconds(SEND_INTERVAL_MS), wokenUp)) {
                 return;
             }
         }
@@ -1373,16 +1524,24 @@ void CSigSharesManager::WorkThreadMain()
 
 void CSigSharesManager::AsyncSign(const CQuorumCPtr& quorum, const uint256& id, const uint256& msgHash)
 {
-    LOCK(cs);
-    pendingSigns.emplace_back(quorum, id, msgHash);
+    bool isPriority = quorumSigningManager->IsPriorityRequestId(quorum->params.type, id);
+    {
+        LOCK(cs);
+        if (isPriority) {
+            pendingPrioritySigns.emplace_back(quorum, id, msgHash);
+        } else {
+            pendingSigns.emplace_back(quorum, id, msgHash);
+        }
+    }
+    WakeupWorkerThread();
 }
 
-bool CSigSharesManager::SignPendingSigShares()
+bool CSigSharesManager::SignPendingSigShares(bool priorityOnly)
 {
     std::vector<std::tuple<const CQuorumCPtr, uint256, uint256>> v;
     {
         LOCK(cs);
-        v = std::move(pendingSigns);
+        v = std::move(priorityOnly ? pendingPrioritySigns : pendingSigns);
     }
 
     for (auto& t : v) {
@@ -1439,13 +1598,10 @@ void CSigSharesManager::ForceReAnnouncement(const CQuorumCPtr& quorum, Consensus
 {
     LOCK(cs);
     auto signHash = CLLMQUtils::BuildSignHash(llmqType, quorum->qc.quorumHash, id, msgHash);
-    auto sigs = sigShares.GetAllForSignHash(signHash);
-    if (sigs) {
-        for (auto& p : *sigs) {
-            // re-announce every sigshare to every node
-            sigSharesToAnnounce.Add(std::make_pair(signHash, p.first), true);
-        }
-    }
+    sigShares.ForEachForSignHash(signHash, [&](const SigShareKey& k, const CSigShare& sigShare) {
+        // re-announce every sigshare to every node
+        sigSharesToAnnounce.Add(k, true);
+    });
     for (auto& p : nodeStates) {
         CSigSharesNodeState& nodeState = p.second;
         auto session = nodeState.GetSessionBySignHash(signHash);
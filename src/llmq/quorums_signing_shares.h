@@ -7,6 +7,9 @@
 
 #include "bls/bls.h"
 #include "chainparams.h"
+#include "compactbitset.h"
+#include "latencyhistogram.h"
+#include "memusage.h"
 #include "net.h"
 #include "random.h"
 #include "saltedhasher.h"
@@ -17,7 +20,11 @@
 
 #include "llmq/quorums.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <memory>
 #include <thread>
+#include <type_traits>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
@@ -43,6 +50,9 @@ public:
 
     SigShareKey key;
 
+    // not part of any message, only used to track the latency of received shares
+    int64_t nTimeReceived{0};
+
 public:
     void UpdateKey();
     const SigShareKey& GetKey() const
@@ -86,7 +96,7 @@ class CSigSharesInv
 {
 public:
     uint32_t sessionId{(uint32_t)-1};
-    std::vector<bool> inv;
+    CCompactBitSet inv;
 
 public:
     ADD_SERIALIZE_METHODS
@@ -98,6 +108,9 @@ public:
 
         READWRITE(VARINT(sessionId));
         READWRITE(COMPACTSIZE(invSize));
+        if (invSize > CCompactBitSet::MAX_SIZE) {
+            throw std::ios_base::failure("invalid inv size");
+        }
         READWRITE(AUTOBITSET(inv, (size_t)invSize));
     }
 
@@ -131,58 +144,170 @@ public:
     std::string ToInvString() const;
 };
 
+/**
+ * Maps (signHash, quorumMember) keys to values.
+ *
+ * All entries of a signHash are stored in a dense slab, together with a small index which maps quorum members to
+ * positions inside the slab. Slabs are themselves kept dense and found through an open addressing hash table, so
+ * that lookups don't chase pointers, iteration is linear and erasing all entries of a signHash does not need to look
+ * up single entries.
+ */
 template<typename T>
 class SigShareMap
 {
 private:
-    std::unordered_map<uint256, std::unordered_map<uint16_t, T>, StaticSaltedHasher> internalMap;
+    typedef std::pair<uint16_t, T> Entry;
+    typedef typename std::aligned_storage<sizeof(Entry), alignof(Entry)>::type EntryStorage;
+
+    static const uint32_t NO_SLAB = (uint32_t)-1;
+    static const uint16_t NO_POS = (uint16_t)-1;
+    static const size_t MIN_TABLE_SIZE = 16;
+    // segments start with 4 entries and double in size until they reach 64 entries
+    static const size_t FIRST_SEGMENT_SHIFT = 2;
+    static const size_t MAX_SEGMENT_SHIFT = 6;
+    static const size_t DOUBLING_SEGMENTS = MAX_SEGMENT_SHIFT - FIRST_SEGMENT_SHIFT;
+    static const size_t DOUBLING_CAPACITY = ((1 << DOUBLING_SEGMENTS) - 1) << FIRST_SEGMENT_SHIFT;
+
+    struct Slab
+    {
+        uint256 signHash;
+        size_t hash;
+        // Entries are constructed in place inside of segments, so that existing entries are never moved when the slab
+        // grows and unused capacity is never initialized
+        std::vector<std::unique_ptr<EntryStorage[]>> segments;
+        size_t capacity{0};
+        size_t count{0};
+        // position of each quorum member's entry or NO_POS
+        std::vector<uint16_t> positions;
+
+        Slab() {}
+        Slab(Slab&& r) :
+            signHash(r.signHash), hash(r.hash), segments(std::move(r.segments)), capacity(r.capacity), count(r.count),
+            positions(std::move(r.positions))
+        {
+            r.capacity = 0;
+            r.count = 0;
+        }
+        Slab& operator=(Slab&& r)
+        {
+            DestroyEntries();
+            signHash = r.signHash;
+            hash = r.hash;
+            segments = std::move(r.segments);
+            capacity = r.capacity;
+            count = r.count;
+            positions = std::move(r.positions);
+            r.capacity = 0;
+            r.count = 0;
+            return *this;
+        }
+        ~Slab()
+        {
+            DestroyEntries();
+        }
+
+        static size_t SegmentSize(size_t i)
+        {
+            return (size_t)1 << std::min(FIRST_SEGMENT_SHIFT + i, (size_t)MAX_SEGMENT_SHIFT);
+        }
+
+        Entry* Ptr(size_t pos) const
+        {
+            size_t segment, offset;
+            if (pos < DOUBLING_CAPACITY) {
+                size_t x = pos + ((size_t)1 << FIRST_SEGMENT_SHIFT);
+                size_t bit = 63 - __builtin_clzll((unsigned long long)x);
+                segment = bit - FIRST_SEGMENT_SHIFT;
+                offset = x - ((size_t)1 << bit);
+            } else {
+                segment = DOUBLING_SEGMENTS + ((pos - DOUBLING_CAPACITY) >> MAX_SEGMENT_SHIFT);
+                offset = (pos - DOUBLING_CAPACITY) & (((size_t)1 << MAX_SEGMENT_SHIFT) - 1);
+            }
+            return reinterpret_cast<Entry*>(&segments[segment][offset]);
+        }
+        Entry& At(size_t pos) const
+        {
+            return *Ptr(pos);
+        }
+
+        void DestroyEntries()
+        {
+            for (size_t i = 0; i < count; i++) {
+                Ptr(i)->~Entry();
+            }
+            count = 0;
+        }
+    };
+
+    std::vector<Slab> slabs;
+    // linear probing, the size is always a power of 2 and at least twice the number of slabs
+    std::vector<uint32_t> table;
+    size_t entryCount{0};
 
 public:
     bool Add(const SigShareKey& k, const T& v)
     {
-        auto& m = internalMap[k.first];
-        return m.emplace(k.second, v).second;
+        auto& slab = GetOrAddSlab(k.first);
+        if (k.second >= slab.positions.size()) {
+            slab.positions.resize(k.second + 1, (uint16_t)NO_POS);
+        } else if (slab.positions[k.second] != NO_POS) {
+            return false;
+        }
+        if (slab.count == slab.capacity) {
+            size_t segmentSize = Slab::SegmentSize(slab.segments.size());
+            slab.segments.emplace_back(new EntryStorage[segmentSize]);
+            slab.capacity += segmentSize;
+        }
+        new (slab.Ptr(slab.count)) Entry(k.second, v);
+        slab.positions[k.second] = (uint16_t)slab.count++;
+        entryCount++;
+        return true;
     }
 
     void Erase(const SigShareKey& k)
     {
-        auto it = internalMap.find(k.first);
-        if (it == internalMap.end()) {
+        size_t slot;
+        if (!FindSlot(k.first, slot)) {
+            return;
+        }
+        auto& slab = slabs[table[slot]];
+        if (k.second >= slab.positions.size() || slab.positions[k.second] == NO_POS) {
             return;
         }
-        it->second.erase(k.second);
-        if (it->second.empty()) {
-            internalMap.erase(it);
+        EraseEntry(slab, slab.positions[k.second]);
+        if (slab.count == 0) {
+            EraseSlab(slot);
         }
     }
 
     void Clear()
     {
-        internalMap.clear();
+        slabs.clear();
+        table.clear();
+        entryCount = 0;
     }
 
     bool Has(const SigShareKey& k) const
     {
-        auto it = internalMap.find(k.first);
-        if (it == internalMap.end()) {
-            return false;
-        }
-        return it->second.count(k.second) != 0;
+        return Get(k) != nullptr;
     }
 
-    T* Get(const SigShareKey& k)
+    const T* Get(const SigShareKey& k) const
     {
-        auto it = internalMap.find(k.first);
-        if (it == internalMap.end()) {
+        size_t slot;
+        if (!FindSlot(k.first, slot)) {
             return nullptr;
         }
-
-        auto jt = it->second.find(k.second);
-        if (jt == it->second.end()) {
+        auto& slab = slabs[table[slot]];
+        if (k.second >= slab.positions.size() || slab.positions[k.second] == NO_POS) {
             return nullptr;
         }
+        return &slab.At(slab.positions[k.second]).second;
+    }
 
-        return &jt->second;
+    T* Get(const SigShareKey& k)
+    {
+        return const_cast<T*>(static_cast<const SigShareMap*>(this)->Get(k));
     }
 
     T& GetOrAdd(const SigShareKey& k)
@@ -197,67 +322,64 @@ public:
 
     const T* GetFirst() const
     {
-        if (internalMap.empty()) {
+        if (slabs.empty()) {
             return nullptr;
         }
-        return &internalMap.begin()->second.begin()->second;
+        return &slabs.front().At(0).second;
     }
 
     size_t Size() const
     {
-        size_t s = 0;
-        for (auto& p : internalMap) {
-            s += p.second.size();
-        }
-        return s;
+        return entryCount;
     }
 
     size_t CountForSignHash(const uint256& signHash) const
     {
-        auto it = internalMap.find(signHash);
-        if (it == internalMap.end()) {
+        size_t slot;
+        if (!FindSlot(signHash, slot)) {
             return 0;
         }
-        return it->second.size();
+        return slabs[table[slot]].count;
     }
 
     bool Empty() const
     {
-        return internalMap.empty();
-    }
-
-    const std::unordered_map<uint16_t, T>* GetAllForSignHash(const uint256& signHash)
-    {
-        auto it = internalMap.find(signHash);
-        if (it == internalMap.end()) {
-            return nullptr;
-        }
-        return &it->second;
+        return slabs.empty();
     }
 
     void EraseAllForSignHash(const uint256& signHash)
     {
-        internalMap.erase(signHash);
+        size_t slot;
+        if (FindSlot(signHash, slot)) {
+            EraseSlab(slot);
+        }
     }
 
     template<typename F>
     void EraseIf(F&& f)
     {
-        for (auto it = internalMap.begin(); it != internalMap.end(); ) {
+        for (size_t i = 0; i < slabs.size(); ) {
+            auto& slab = slabs[i];
             SigShareKey k;
-            k.first = it->first;
-            for (auto jt = it->second.begin(); jt != it->second.end(); ) {
-                k.second = jt->first;
-                if (f(k, jt->second)) {
-                    jt = it->second.erase(jt);
+            k.first = slab.signHash;
+            for (size_t j = 0; j < slab.count; ) {
+                auto& e = slab.At(j);
+                k.second = e.first;
+                if (f(k, e.second)) {
+                    // moves the last entry to j
+                    EraseEntry(slab, j);
                 } else {
-                    ++jt;
+                    ++j;
                 }
             }
-            if (it->second.empty()) {
-                it = internalMap.erase(it);
+            if (slab.count == 0) {
+                size_t slot;
+                bool found = FindSlot(slab.signHash, slot);
+                assert(found);
+                // moves the last slab to i
+                EraseSlab(slot);
             } else {
-                ++it;
+                ++i;
             }
         }
     }
@@ -265,15 +387,144 @@ public:
     template<typename F>
     void ForEach(F&& f)
     {
-        for (auto& p : internalMap) {
-            SigShareKey k;
-            k.first = p.first;
-            for (auto& p2 : p.second) {
-                k.second = p2.first;
-                f(k, p2.second);
+        for (auto& slab : slabs) {
+            ForEachInSlab(slab, f);
+        }
+    }
+
+    template<typename F>
+    void ForEachForSignHash(const uint256& signHash, F&& f)
+    {
+        size_t slot;
+        if (FindSlot(signHash, slot)) {
+            ForEachInSlab(slabs[table[slot]], f);
+        }
+    }
+
+    // Does not include memory allocated by the values themselves
+    size_t DynamicUsage() const
+    {
+        size_t usage = memusage::DynamicUsage(slabs) + memusage::DynamicUsage(table);
+        for (auto& slab : slabs) {
+            usage += memusage::DynamicUsage(slab.segments) + memusage::DynamicUsage(slab.positions);
+            for (size_t i = 0; i < slab.segments.size(); i++) {
+                usage += memusage::MallocUsage(sizeof(EntryStorage) * Slab::SegmentSize(i));
+            }
+        }
+        return usage;
+    }
+
+private:
+    template<typename F>
+    void ForEachInSlab(Slab& slab, F& f)
+    {
+        SigShareKey k;
+        k.first = slab.signHash;
+        size_t pos = 0;
+        for (size_t i = 0; i < slab.segments.size() && pos < slab.count; i++) {
+            Entry* segment = reinterpret_cast<Entry*>(slab.segments[i].get());
+            size_t n = std::min(Slab::SegmentSize(i), slab.count - pos);
+            for (size_t j = 0; j < n; j++) {
+                k.second = segment[j].first;
+                f(k, segment[j].second);
             }
+            pos += n;
         }
     }
+
+    // Returns true if the signHash was found. Otherwise slotRet is the empty slot where it would be inserted
+    bool FindSlot(const uint256& signHash, size_t& slotRet) const
+    {
+        if (table.empty()) {
+            return false;
+        }
+        size_t mask = table.size() - 1;
+        size_t slot = StaticSaltedHasher()(signHash) & mask;
+        while (table[slot] != NO_SLAB) {
+            if (slabs[table[slot]].signHash == signHash) {
+                slotRet = slot;
+                return true;
+            }
+            slot = (slot + 1) & mask;
+        }
+        slotRet = slot;
+        return false;
+    }
+
+    Slab& GetOrAddSlab(const uint256& signHash)
+    {
+        size_t slot;
+        if (FindSlot(signHash, slot)) {
+            return slabs[table[slot]];
+        }
+        if ((slabs.size() + 1) * 2 > table.size()) {
+            Rehash(std::max((size_t)MIN_TABLE_SIZE, table.size() * 2));
+            FindSlot(signHash, slot);
+        }
+        table[slot] = (uint32_t)slabs.size();
+        slabs.emplace_back();
+        auto& slab = slabs.back();
+        slab.signHash = signHash;
+        slab.hash = StaticSaltedHasher()(signHash);
+        return slab;
+    }
+
+    void Rehash(size_t newSize)
+    {
+        table.assign(newSize, (uint32_t)NO_SLAB);
+        size_t mask = newSize - 1;
+        for (size_t i = 0; i < slabs.size(); i++) {
+            size_t slot = slabs[i].hash & mask;
+            while (table[slot] != NO_SLAB) {
+                slot = (slot + 1) & mask;
+            }
+            table[slot] = (uint32_t)i;
+        }
+    }
+
+    void EraseEntry(Slab& slab, size_t pos)
+    {
+        auto& e = slab.At(pos);
+        auto& last = slab.At(slab.count - 1);
+        slab.positions[e.first] = NO_POS;
+        if (&e != &last) {
+            e = std::move(last);
+            slab.positions[e.first] = (uint16_t)pos;
+        }
+        last.~Entry();
+        slab.count--;
+        entryCount--;
+    }
+
+    // Removes the slab referenced by the given table slot. The last slab is moved into its place to keep slabs dense
+    void EraseSlab(size_t slot)
+    {
+        uint32_t idx = table[slot];
+        entryCount -= slabs[idx].count;
+
+        // backward shift deletion, so that no tombstones are needed
+        size_t mask = table.size() - 1;
+        for (size_t next = (slot + 1) & mask; table[next] != NO_SLAB; next = (next + 1) & mask) {
+            size_t home = slabs[table[next]].hash & mask;
+            // move the entry into the hole if its home slot is not in the cyclic range (slot, next]
+            bool inRange = slot < next ? (home > slot && home <= next) : (home > slot || home <= next);
+            if (!inRange) {
+                table[slot] = table[next];
+                slot = next;
+            }
+        }
+        table[slot] = NO_SLAB;
+
+        uint32_t lastIdx = (uint32_t)slabs.size() - 1;
+        if (idx != lastIdx) {
+            size_t lastSlot;
+            bool found = FindSlot(slabs[lastIdx].signHash, lastSlot);
+            assert(found);
+            table[lastSlot] = idx;
+            slabs[idx] = std::move(slabs[lastIdx]);
+        }
+        slabs.pop_back();
+    }
 };
 
 class CSigSharesNodeState
@@ -328,6 +579,17 @@ public:
     void RemoveSession(const uint256& signHash);
 };
 
+// Latencies of the stages incoming sig shares go through until the recovered signature is available
+struct CSigSharesLatencyStats
+{
+    // from receiving a sig share until it is verified
+    CLatencyHistogram receiveToVerify;
+    // from the share which completes the threshold until the signature is recovered
+    CLatencyHistogram verifyToRecover;
+    // from the first share of a signing session until the signature is recovered
+    CLatencyHistogram firstShareToRecover;
+};
+
 class CSigSharesManager : public CRecoveredSigsListener
 {
     static const int64_t SESSION_NEW_SHARES_TIMEOUT = 60;
@@ -340,16 +602,33 @@ class CSigSharesManager : public CRecoveredSigsListener
     // 400 is the maximum quorum size, so this is also the maximum number of sigs we need to support
     const size_t MAX_MSGS_TOTAL_BATCHED_SIGS = 400;
 
+    // the number of sessions verified at once grows with the number of pending sig shares
+    static const size_t MIN_UNIQUE_SESSIONS_TO_VERIFY = 32;
+    static const size_t MAX_UNIQUE_SESSIONS_TO_VERIFY = 512;
+    // verification is split into jobs of at least this many shares
+    static const size_t MIN_SIGSHARES_PER_VERIFY_JOB = 32;
+
+    // outgoing messages are batched for up to this long, unless only a few shares need to be announced
+    static const int64_t SEND_INTERVAL_MS = 100;
+    static const size_t MAX_IMMEDIATE_SEND_SHARES = 16;
+
 private:
     CCriticalSection cs;
 
     std::thread workThread;
     CThreadInterrupt workInterrupt;
 
+    // signals the work thread that new sig shares, recovered sigs or sign requests are pending
+    std::mutex workMutex;
+    std::condition_variable workCond;
+    bool workPending{false};
+
     SigShareMap<CSigShare> sigShares;
 
     // stores time of last receivedSigShare. Used to detect timeouts
     std::unordered_map<uint256, int64_t, StaticSaltedHasher> timeSeenForSessions;
+    // time (in microseconds) of the first sigShare of a session, used for latency stats
+    std::unordered_map<uint256, int64_t, StaticSaltedHasher> timeFirstShareForSessions;
 
     std::unordered_map<NodeId, CSigSharesNodeState> nodeStates;
     SigShareMap<std::pair<NodeId, int64_t>> sigSharesRequested;
@@ -357,12 +636,20 @@ private:
 
     std::vector<std::tuple<const CQuorumCPtr, uint256, uint256>> pendingSigns;
 
+    // Sessions of priority request ids (see CSigningManager::AddPriorityRequestId) are signed and verified in a separate
+    // pass before all other sessions. Their messages are sent out without waiting for SEND_INTERVAL_MS
+    std::vector<std::tuple<const CQuorumCPtr, uint256, uint256>> pendingPrioritySigns;
+    std::unordered_set<uint256, StaticSaltedHasher> pendingPrioritySignHashes;
+    std::atomic<bool> prioritySendPending{false};
+
     // must be protected by cs
     FastRandomContext rnd;
 
     int64_t lastCleanupTime{0};
     std::atomic<uint32_t> recoveredSigsCounter{0};
 
+    CSigSharesLatencyStats latencyStats;
+
 public:
     CSigSharesManager();
     ~CSigSharesManager();
@@ -372,6 +659,7 @@ public:
     void RegisterAsRecoveredSigsListener();
     void UnregisterAsRecoveredSigsListener();
     void InterruptWorkerThread();
+    void WakeupWorkerThread();
 
 public:
     void ProcessMessage(CNode* pnode, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
@@ -382,6 +670,8 @@ public:
 
     void HandleNewRecoveredSig(const CRecoveredSig& recoveredSig);
 
+    const CSigSharesLatencyStats& GetLatencyStats() const { return latencyStats; }
+
 private:
     // all of these return false when the currently processed message should be aborted (as each message actually contains multiple messages)
     bool ProcessMessageSigSesAnn(CNode* pfrom, const CSigSesAnn& ann, CConnman& connman);
@@ -392,10 +682,11 @@ private:
     bool VerifySigSharesInv(NodeId from, Consensus::LLMQType llmqType, const CSigSharesInv& inv);
     bool PreVerifyBatchedSigShares(NodeId nodeId, const CSigSharesNodeState::SessionInfo& session, const CBatchedSigShares& batchedSigShares, bool& retBan);
 
-    void CollectPendingSigSharesToVerify(size_t maxUniqueSessions,
+    void CollectPendingSigSharesToVerify(bool priorityOnly, size_t maxUniqueSessions,
             std::unordered_map<NodeId, std::vector<CSigShare>>& retSigShares,
             std::unordered_map<std::pair<Consensus::LLMQType, uint256>, CQuorumCPtr, StaticSaltedHasher>& retQuorums);
-    bool ProcessPendingSigShares(CConnman& connman);
+    size_t GetMaxUniqueSessionsToVerify();
+    bool ProcessPendingSigShares(CConnman& connman, bool priorityOnly);
 
     void ProcessPendingSigSharesFromNode(NodeId nodeId,
             const std::vector<CSigShare>& sigShares,
@@ -419,7 +710,8 @@ private:
     void CollectSigSharesToRequest(std::unordered_map<NodeId, std::unordered_map<uint256, CSigSharesInv, StaticSaltedHasher>>& sigSharesToRequest);
     void CollectSigSharesToSend(std::unordered_map<NodeId, std::unordered_map<uint256, CBatchedSigShares, StaticSaltedHasher>>& sigSharesToSend);
     void CollectSigSharesToAnnounce(std::unordered_map<NodeId, std::unordered_map<uint256, CSigSharesInv, StaticSaltedHasher>>& sigSharesToAnnounce);
-    bool SignPendingSigShares();
+    bool SignPendingSigShares(bool priorityOnly);
+    bool WaitForWork(std::chrono::milliseconds maxWait, bool& retWokenUp);
     void WorkThreadMain();
 };
 
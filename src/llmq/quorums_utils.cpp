@@ -3,24 +3,73 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "quorums.h"
+#include "quorums_blockprocessor.h"
 #include "quorums_utils.h"
 
 #include "chainparams.h"
 #include "random.h"
+#include "saltedhasher.h"
+#include "unordered_lru_cache.h"
 #include "validation.h"
 
 namespace llmq
 {
 
+// Quorum members only depend on the quorum block, so they never have to be invalidated. The cache is large enough to
+// hold the active and the DKG quorums of all LLMQ types.
+static CCriticalSection cs_quorumMembersCache;
+static unordered_lru_cache<std::pair<Consensus::LLMQType, uint256>, std::vector<CDeterministicMNCPtr>, StaticSaltedHasher, 64> quorumMembersCache;
+static std::atomic<uint64_t> quorumMembersCacheHits{0};
+static std::atomic<uint64_t> quorumMembersCacheMisses{0};
+
 std::vector<CDeterministicMNCPtr> CLLMQUtils::GetAllQuorumMembers(Consensus::LLMQType llmqType, const CBlockIndex* pindexQuorum)
 {
+    auto cacheKey = std::make_pair(llmqType, pindexQuorum->GetBlockHash());
+    std::vector<CDeterministicMNCPtr> members;
+    {
+        LOCK(cs_quorumMembersCache);
+        if (quorumMembersCache.get(cacheKey, members)) {
+            quorumMembersCacheHits++;
+            return members;
+        }
+    }
+    quorumMembersCacheMisses++;
+
     auto& params = Params().GetConsensus().llmqs.at(llmqType);
     auto allMns = deterministicMNManager->GetListForBlock(pindexQuorum);
-    auto modifier = ::SerializeHash(std::make_pair((uint8_t) llmqType, pindexQuorum->GetBlockHash()));
-    return allMns.CalculateQuorum(params.size, modifier);
+
+    // mined quorums have their members stored in the DB, so we only need to resolve the internal ids
+    CMinedQuorumMembers minedMembers;
+    if (quorumBlockProcessor && quorumBlockProcessor->GetMinedQuorumMembers(llmqType, pindexQuorum->GetBlockHash(), minedMembers)) {
+        members.reserve(minedMembers.internalIds.size());
+        for (auto internalId : minedMembers.internalIds) {
+            auto dmn = allMns.GetMNByInternalId(internalId);
+            if (!dmn) {
+                LogPrintf("CLLMQUtils::%s -- stored member %d of quorum %s not found in MN list\n", __func__,
+                          internalId, pindexQuorum->GetBlockHash().ToString());
+                members.clear();
+                break;
+            }
+            members.emplace_back(dmn);
+        }
+    }
+    if (members.empty()) {
+        auto modifier = ::SerializeHash(std::make_pair((uint8_t) llmqType, pindexQuorum->GetBlockHash()));
+        members = allMns.CalculateQuorum(params.size, modifier);
+    }
+
+    LOCK(cs_quorumMembersCache);
+    quorumMembersCache.insert(cacheKey, members);
+    return members;
+}
+
+void CLLMQUtils::GetQuorumMembersCacheStats(uint64_t& hitsRet, uint64_t& missesRet)
+{
+    hitsRet = quorumMembersCacheHits;
+    missesRet = quorumMembersCacheMisses;
 }
 
-uint256 CLLMQUtils::BuildCommitmentHash(uint8_t llmqType, const uint256& blockHash, const std::vector<bool>& validMembers, const CBLSPublicKey& pubKey, const uint256& vvecHash)
+uint256 CLLMQUtils::BuildCommitmentHash(uint8_t llmqType, const uint256& blockHash, const CCompactBitSet& validMembers, const CBLSPublicKey& pubKey, const uint256& vvecHash)
 {
     CHashWriter hw(SER_NETWORK, 0);
     hw << llmqType;
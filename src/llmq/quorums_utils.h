@@ -5,6 +5,7 @@
 #ifndef BEENODE_QUORUMS_UTILS_H
 #define BEENODE_QUORUMS_UTILS_H
 
+#include "compactbitset.h"
 #include "consensus/params.h"
 #include "net.h"
 
@@ -20,8 +21,10 @@ class CLLMQUtils
 public:
     // includes members which failed DKG
     static std::vector<CDeterministicMNCPtr> GetAllQuorumMembers(Consensus::LLMQType llmqType, const CBlockIndex* pindexQuorum);
+    // hit/miss counters of the cache behind GetAllQuorumMembers
+    static void GetQuorumMembersCacheStats(uint64_t& hitsRet, uint64_t& missesRet);
 
-    static uint256 BuildCommitmentHash(uint8_t llmqType, const uint256& blockHash, const std::vector<bool>& validMembers, const CBLSPublicKey& pubKey, const uint256& vvecHash);
+    static uint256 BuildCommitmentHash(uint8_t llmqType, const uint256& blockHash, const CCompactBitSet& validMembers, const CBLSPublicKey& pubKey, const uint256& vvecHash);
     static uint256 BuildSignHash(Consensus::LLMQType llmqType, const uint256& quorumHash, const uint256& id, const uint256& msgHash);
 
     // works for sig shares and recovered sigs
@@ -36,6 +36,11 @@
 #include <fcntl.h>
 #endif
 
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
 #ifdef USE_UPNP
 #include <miniupnpc/miniupnpc.h>
 #include <miniupnpc/miniwget.h>
@@ -52,6 +57,9 @@
 // We add a random period time (0 to 1 seconds) to feeler connections to prevent synchronization.
 #define FEELER_SLEEP_WINDOW 1
 
+// How long the socket handler waits for socket events before it polls vSend and checks for inactivity
+static const int SELECT_TIMEOUT_MILLISECONDS = 50;
+
 #if !defined(HAVE_MSG_NOSIGNAL) && !defined(MSG_NOSIGNAL)
 #define MSG_NOSIGNAL 0
 #endif
@@ -67,8 +75,6 @@
 #endif
 #endif
 
-const static std::string NET_MESSAGE_COMMAND_OTHER = "*other*";
-
 constexpr const CConnman::CFullyConnectedOnly CConnman::FullyConnectedOnly;
 constexpr const CConnman::CAllNodes CConnman::AllNodes;
 
@@ -889,6 +895,7 @@ size_t CConnman::SocketSendData(CNode *pnode) const
                 it++;
             } else {
                 // could not send full message; stop sending more
+                pnode->fCanSendData = false;
                 break;
             }
         } else {
@@ -902,6 +909,7 @@ size_t CConnman::SocketSendData(CNode *pnode) const
                 }
             }
             // couldn't send anything at all
+            pnode->fCanSendData = false;
             break;
         }
     }
@@ -1179,341 +1187,522 @@ void CConnman::AcceptConnection(const ListenSocket& hListenSocket) {
     {
         LOCK(cs_vNodes);
         vNodes.push_back(pnode);
+        RegisterEvents(pnode);
     }
 }
 
-void CConnman::ThreadSocketHandler()
+void CConnman::DisconnectNodes()
 {
-    unsigned int nPrevNodeCount = 0;
-    while (!interruptNet)
     {
-        //
-        // Disconnect nodes
-        //
+        LOCK(cs_vNodes);
+        // Disconnect unused nodes
+        std::vector<CNode*> vNodesCopy = vNodes;
+        BOOST_FOREACH(CNode* pnode, vNodesCopy)
         {
-            LOCK(cs_vNodes);
-            // Disconnect unused nodes
-            std::vector<CNode*> vNodesCopy = vNodes;
-            BOOST_FOREACH(CNode* pnode, vNodesCopy)
+            if (pnode->fDisconnect)
             {
-                if (pnode->fDisconnect)
-                {
-                    LogPrintf("ThreadSocketHandler -- removing node: peer=%d addr=%s nRefCount=%d fInbound=%d fMasternode=%d\n",
-                              pnode->id, pnode->addr.ToString(), pnode->GetRefCount(), pnode->fInbound, pnode->fMasternode);
+                LogPrintf("ThreadSocketHandler -- removing node: peer=%d addr=%s nRefCount=%d fInbound=%d fMasternode=%d\n",
+                          pnode->id, pnode->addr.ToString(), pnode->GetRefCount(), pnode->fInbound, pnode->fMasternode);
 
-                    // remove from vNodes
-                    vNodes.erase(remove(vNodes.begin(), vNodes.end(), pnode), vNodes.end());
+                // remove from vNodes
+                vNodes.erase(remove(vNodes.begin(), vNodes.end(), pnode), vNodes.end());
 
-                    // release outbound grant (if any)
-                    pnode->grantOutbound.Release();
-                    pnode->grantMasternodeOutbound.Release();
+                // release outbound grant (if any)
+                pnode->grantOutbound.Release();
+                pnode->grantMasternodeOutbound.Release();
 
-                    // close socket and cleanup
-                    pnode->CloseSocketDisconnect();
+                // close socket and cleanup
+                // (closing the socket also removes it from the epoll set, so no events can reference the node afterwards)
+                pnode->CloseSocketDisconnect();
 
-                    // hold in disconnected pool until all refs are released
-                    pnode->Release();
-                    vNodesDisconnected.push_back(pnode);
-                }
+                // hold in disconnected pool until all refs are released
+                pnode->Release();
+                vNodesDisconnected.push_back(pnode);
             }
         }
+    }
+    {
+        // Delete disconnected nodes
+        std::list<CNode*> vNodesDisconnectedCopy = vNodesDisconnected;
+        BOOST_FOREACH(CNode* pnode, vNodesDisconnectedCopy)
         {
-            // Delete disconnected nodes
-            std::list<CNode*> vNodesDisconnectedCopy = vNodesDisconnected;
-            BOOST_FOREACH(CNode* pnode, vNodesDisconnectedCopy)
-            {
-                // wait until threads are done using it
-                if (pnode->GetRefCount() <= 0) {
-                    bool fDelete = false;
-                    {
-                        TRY_LOCK(pnode->cs_inventory, lockInv);
-                        if (lockInv) {
-                            TRY_LOCK(pnode->cs_vSend, lockSend);
-                            if (lockSend) {
-                                fDelete = true;
-                            }
+            // wait until threads are done using it
+            if (pnode->GetRefCount() <= 0) {
+                bool fDelete = false;
+                {
+                    TRY_LOCK(pnode->cs_inventory, lockInv);
+                    if (lockInv) {
+                        TRY_LOCK(pnode->cs_vSend, lockSend);
+                        if (lockSend) {
+                            fDelete = true;
                         }
                     }
-                    if (fDelete) {
-                        vNodesDisconnected.remove(pnode);
-                        DeleteNode(pnode);
-                    }
+                }
+                if (fDelete) {
+                    vNodesDisconnected.remove(pnode);
+                    DeleteNode(pnode);
                 }
             }
         }
-        size_t vNodesSize;
+    }
+}
+
+void CConnman::NotifyNumConnectionsChanged()
+{
+    size_t vNodesSize;
+    {
+        LOCK(cs_vNodes);
+        vNodesSize = vNodes.size();
+    }
+    if(vNodesSize != nPrevNodeCount) {
+        nPrevNodeCount = vNodesSize;
+        if(clientInterface)
+            clientInterface->NotifyNumConnectionsChanged(nPrevNodeCount);
+    }
+}
+
+void CConnman::InactivityCheck(CNode* pnode)
+{
+    int64_t nTime = GetSystemTimeInSeconds();
+    if (nTime - pnode->nTimeConnected > 60)
+    {
+        if (pnode->nLastRecv == 0 || pnode->nLastSend == 0)
+        {
+            LogPrint("net", "socket no message in first 60 seconds, %d %d from %d\n", pnode->nLastRecv != 0, pnode->nLastSend != 0, pnode->id);
+            pnode->fDisconnect = true;
+        }
+        else if (nTime - pnode->nLastSend > TIMEOUT_INTERVAL)
         {
-            LOCK(cs_vNodes);
-            vNodesSize = vNodes.size();
+            LogPrintf("socket sending timeout: %is\n", nTime - pnode->nLastSend);
+            pnode->fDisconnect = true;
         }
-        if(vNodesSize != nPrevNodeCount) {
-            nPrevNodeCount = vNodesSize;
-            if(clientInterface)
-                clientInterface->NotifyNumConnectionsChanged(nPrevNodeCount);
+        else if (nTime - pnode->nLastRecv > (pnode->nVersion > BIP0031_VERSION ? TIMEOUT_INTERVAL : 90*60))
+        {
+            LogPrintf("socket receive timeout: %is\n", nTime - pnode->nLastRecv);
+            pnode->fDisconnect = true;
+        }
+        else if (pnode->nPingNonceSent && pnode->nPingUsecStart + TIMEOUT_INTERVAL * 1000000 < GetTimeMicros())
+        {
+            LogPrintf("ping timeout: %fs\n", 0.000001 * (GetTimeMicros() - pnode->nPingUsecStart));
+            pnode->fDisconnect = true;
+        }
+        else if (!pnode->fSuccessfullyConnected)
+        {
+            LogPrintf("version handshake timeout from %d\n", pnode->id);
+            pnode->fDisconnect = true;
         }
+    }
+}
 
-        //
-        // Find which sockets have data to receive
-        //
-        struct timeval timeout;
-        timeout.tv_sec  = 0;
-        timeout.tv_usec = 50000; // frequency to poll pnode->vSend
-
-        fd_set fdsetRecv;
-        fd_set fdsetSend;
-        fd_set fdsetError;
-        FD_ZERO(&fdsetRecv);
-        FD_ZERO(&fdsetSend);
-        FD_ZERO(&fdsetError);
-        SOCKET hSocketMax = 0;
-        bool have_fds = false;
+/**
+ * Reads up to 64k from the socket and hands off all complete messages to the message handler.
+ * Returns true if the read buffer was filled completely, which means that there might be more data in the socket.
+ */
+bool CConnman::SocketRecvData(CNode* pnode)
+{
+    // typical socket buffer is 8K-64K
+    char pchBuf[0x10000];
+    int nBytes = 0;
+    {
+        LOCK(pnode->cs_hSocket);
+        if (pnode->hSocket == INVALID_SOCKET)
+            return false;
+        nBytes = recv(pnode->hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
+    }
+    if (nBytes > 0)
+    {
+        bool notify = false;
+        if (!pnode->ReceiveMsgBytes(pchBuf, nBytes, notify))
+            pnode->CloseSocketDisconnect();
+        RecordBytesRecv(nBytes);
+        if (notify) {
+            size_t nSizeAdded = 0;
+            auto it(pnode->vRecvMsg.begin());
+            for (; it != pnode->vRecvMsg.end(); ++it) {
+                if (!it->complete())
+                    break;
+                nSizeAdded += it->vRecv.size() + CMessageHeader::HEADER_SIZE;
+            }
+            {
+                LOCK(pnode->cs_vProcessMsg);
+                pnode->vProcessMsg.splice(pnode->vProcessMsg.end(), pnode->vRecvMsg, pnode->vRecvMsg.begin(), it);
+                pnode->nProcessQueueSize += nSizeAdded;
+                pnode->fPauseRecv = pnode->nProcessQueueSize > nReceiveFloodSize;
+            }
+            WakeMessageHandler(pnode);
+        }
+        return nBytes == (int)sizeof(pchBuf);
+    }
+    else if (nBytes == 0)
+    {
+        // socket closed gracefully
+        if (!pnode->fDisconnect)
+            LogPrint("net", "socket closed\n");
+        pnode->CloseSocketDisconnect();
+    }
+    else if (nBytes < 0)
+    {
+        // error
+        int nErr = WSAGetLastError();
+        if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
+        {
+            if (!pnode->fDisconnect)
+                LogPrintf("socket recv error %s\n", NetworkErrorString(nErr));
+            pnode->CloseSocketDisconnect();
+        }
+    }
+    return false;
+}
+
+void CConnman::SocketHandlerSelect()
+{
+    //
+    // Find which sockets have data to receive
+    //
+    struct timeval timeout;
+    timeout.tv_sec  = 0;
+    timeout.tv_usec = SELECT_TIMEOUT_MILLISECONDS * 1000; // frequency to poll pnode->vSend
+
+    fd_set fdsetRecv;
+    fd_set fdsetSend;
+    fd_set fdsetError;
+    FD_ZERO(&fdsetRecv);
+    FD_ZERO(&fdsetSend);
+    FD_ZERO(&fdsetError);
+    SOCKET hSocketMax = 0;
+    bool have_fds = false;
 
 #ifndef WIN32
-        // We add a pipe to the read set so that the select() call can be woken up from the outside
-        // This is done when data is available for sending and at the same time optimistic sending was disabled
-        // when pushing the data.
-        // This is currently only implemented for POSIX compliant systems. This means that Windows will fall back to
-        // timing out after 50ms and then trying to send. This is ok as we assume that heavy-load daemons are usually
-        // run on Linux and friends.
-        FD_SET(wakeupPipe[0], &fdsetRecv);
-        hSocketMax = std::max(hSocketMax, (SOCKET)wakeupPipe[0]);
-        have_fds = true;
+    // We add a pipe to the read set so that the select() call can be woken up from the outside
+    // This is done when data is available for sending and at the same time optimistic sending was disabled
+    // when pushing the data.
+    // This is currently only implemented for POSIX compliant systems. This means that Windows will fall back to
+    // timing out after 50ms and then trying to send. This is ok as we assume that heavy-load daemons are usually
+    // run on Linux and friends.
+    FD_SET(wakeupPipe[0], &fdsetRecv);
+    hSocketMax = std::max(hSocketMax, (SOCKET)wakeupPipe[0]);
+    have_fds = true;
 #endif
 
-        BOOST_FOREACH(const ListenSocket& hListenSocket, vhListenSocket) {
-            FD_SET(hListenSocket.socket, &fdsetRecv);
-            hSocketMax = std::max(hSocketMax, hListenSocket.socket);
-            have_fds = true;
-        }
+    BOOST_FOREACH(const ListenSocket& hListenSocket, vhListenSocket) {
+        FD_SET(hListenSocket.socket, &fdsetRecv);
+        hSocketMax = std::max(hSocketMax, hListenSocket.socket);
+        have_fds = true;
+    }
 
+    {
+        LOCK(cs_vNodes);
+        BOOST_FOREACH(CNode* pnode, vNodes)
         {
-            LOCK(cs_vNodes);
-            BOOST_FOREACH(CNode* pnode, vNodes)
+            // Implement the following logic:
+            // * If there is data to send, select() for sending data. As this only
+            //   happens when optimistic write failed, we choose to first drain the
+            //   write buffer in this case before receiving more. This avoids
+            //   needlessly queueing received data, if the remote peer is not themselves
+            //   receiving data. This means properly utilizing TCP flow control signalling.
+            // * Otherwise, if there is space left in the receive buffer, select() for
+            //   receiving data.
+            // * Hand off all complete messages to the processor, to be handled without
+            //   blocking here.
+
+            bool select_recv = !pnode->fPauseRecv;
+            bool select_send;
             {
-                // Implement the following logic:
-                // * If there is data to send, select() for sending data. As this only
-                //   happens when optimistic write failed, we choose to first drain the
-                //   write buffer in this case before receiving more. This avoids
-                //   needlessly queueing received data, if the remote peer is not themselves
-                //   receiving data. This means properly utilizing TCP flow control signalling.
-                // * Otherwise, if there is space left in the receive buffer, select() for
-                //   receiving data.
-                // * Hand off all complete messages to the processor, to be handled without
-                //   blocking here.
-
-                bool select_recv = !pnode->fPauseRecv;
-                bool select_send;
-                {
-                    LOCK(pnode->cs_vSend);
-                    select_send = !pnode->vSendMsg.empty();
-                }
+                LOCK(pnode->cs_vSend);
+                select_send = !pnode->vSendMsg.empty();
+            }
 
-                LOCK(pnode->cs_hSocket);
-                if (pnode->hSocket == INVALID_SOCKET)
-                    continue;
+            LOCK(pnode->cs_hSocket);
+            if (pnode->hSocket == INVALID_SOCKET)
+                continue;
 
-                FD_SET(pnode->hSocket, &fdsetError);
-                hSocketMax = std::max(hSocketMax, pnode->hSocket);
-                have_fds = true;
+            FD_SET(pnode->hSocket, &fdsetError);
+            hSocketMax = std::max(hSocketMax, pnode->hSocket);
+            have_fds = true;
 
-                if (select_send) {
-                    FD_SET(pnode->hSocket, &fdsetSend);
-                    continue;
-                }
-                if (select_recv) {
-                    FD_SET(pnode->hSocket, &fdsetRecv);
-                }
+            if (select_send) {
+                FD_SET(pnode->hSocket, &fdsetSend);
+                continue;
+            }
+            if (select_recv) {
+                FD_SET(pnode->hSocket, &fdsetRecv);
             }
         }
+    }
 
-        wakeupSelectNeeded = true;
-        int nSelect = select(have_fds ? hSocketMax + 1 : 0,
-                             &fdsetRecv, &fdsetSend, &fdsetError, &timeout);
-        wakeupSelectNeeded = false;
-        if (interruptNet)
-            return;
+    wakeupSelectNeeded = true;
+    int nSelect = select(have_fds ? hSocketMax + 1 : 0,
+                         &fdsetRecv, &fdsetSend, &fdsetError, &timeout);
+    wakeupSelectNeeded = false;
+    if (interruptNet)
+        return;
 
-        if (nSelect == SOCKET_ERROR)
+    if (nSelect == SOCKET_ERROR)
+    {
+        if (have_fds)
         {
-            if (have_fds)
-            {
-                int nErr = WSAGetLastError();
-                LogPrintf("socket select error %s\n", NetworkErrorString(nErr));
-                for (unsigned int i = 0; i <= hSocketMax; i++)
-                    FD_SET(i, &fdsetRecv);
-            }
-            FD_ZERO(&fdsetSend);
-            FD_ZERO(&fdsetError);
-            if (!interruptNet.sleep_for(std::chrono::milliseconds(timeout.tv_usec/1000)))
-                return;
+            int nErr = WSAGetLastError();
+            LogPrintf("socket select error %s\n", NetworkErrorString(nErr));
+            for (unsigned int i = 0; i <= hSocketMax; i++)
+                FD_SET(i, &fdsetRecv);
         }
+        FD_ZERO(&fdsetSend);
+        FD_ZERO(&fdsetError);
+        if (!interruptNet.sleep_for(std::chrono::milliseconds(timeout.tv_usec/1000)))
+            return;
+    }
 
 #ifndef WIN32
-        // drain the wakeup pipe
-        if (FD_ISSET(wakeupPipe[0], &fdsetRecv)) {
-            LogPrint("net", "woke up select()\n");
-            char buf[128];
-            while (true) {
-                int r = read(wakeupPipe[0], buf, sizeof(buf));
-                if (r <= 0) {
-                    break;
-                }
+    // drain the wakeup pipe
+    if (FD_ISSET(wakeupPipe[0], &fdsetRecv)) {
+        LogPrint("net", "woke up select()\n");
+        char buf[128];
+        while (true) {
+            int r = read(wakeupPipe[0], buf, sizeof(buf));
+            if (r <= 0) {
+                break;
             }
         }
+    }
 #endif
 
+    //
+    // Accept new connections
+    //
+    BOOST_FOREACH(const ListenSocket& hListenSocket, vhListenSocket)
+    {
+        if (hListenSocket.socket != INVALID_SOCKET && FD_ISSET(hListenSocket.socket, &fdsetRecv))
+        {
+            AcceptConnection(hListenSocket);
+        }
+    }
+
+    //
+    // Service each socket
+    //
+    std::vector<CNode*> vNodesCopy = CopyNodeVector();
+    BOOST_FOREACH(CNode* pnode, vNodesCopy)
+    {
+        if (interruptNet)
+            return;
+
         //
-        // Accept new connections
+        // Receive
         //
-        BOOST_FOREACH(const ListenSocket& hListenSocket, vhListenSocket)
+        bool recvSet = false;
+        bool sendSet = false;
+        bool errorSet = false;
         {
-            if (hListenSocket.socket != INVALID_SOCKET && FD_ISSET(hListenSocket.socket, &fdsetRecv))
-            {
-                AcceptConnection(hListenSocket);
-            }
+            LOCK(pnode->cs_hSocket);
+            if (pnode->hSocket == INVALID_SOCKET)
+                continue;
+            recvSet = FD_ISSET(pnode->hSocket, &fdsetRecv);
+            sendSet = FD_ISSET(pnode->hSocket, &fdsetSend);
+            errorSet = FD_ISSET(pnode->hSocket, &fdsetError);
+        }
+        if (recvSet || errorSet)
+        {
+            SocketRecvData(pnode);
         }
 
         //
-        // Service each socket
+        // Send
         //
-        std::vector<CNode*> vNodesCopy = CopyNodeVector();
-        BOOST_FOREACH(CNode* pnode, vNodesCopy)
+        if (sendSet)
         {
-            if (interruptNet)
-                return;
+            LOCK(pnode->cs_vSend);
+            size_t nBytes = SocketSendData(pnode);
+            if (nBytes) {
+                RecordBytesSent(nBytes);
+            }
+        }
 
-            //
-            // Receive
-            //
-            bool recvSet = false;
-            bool sendSet = false;
-            bool errorSet = false;
-            {
-                LOCK(pnode->cs_hSocket);
-                if (pnode->hSocket == INVALID_SOCKET)
-                    continue;
-                recvSet = FD_ISSET(pnode->hSocket, &fdsetRecv);
-                sendSet = FD_ISSET(pnode->hSocket, &fdsetSend);
-                errorSet = FD_ISSET(pnode->hSocket, &fdsetError);
+        InactivityCheck(pnode);
+    }
+    ReleaseNodeVector(vNodesCopy);
+}
+
+#ifdef USE_EPOLL
+void CConnman::SocketHandlerEpoll()
+{
+    // All sockets are registered in edge-triggered mode when they are created (see RegisterEvents), so we only learn
+    // about readiness changes here. Each node remembers whether its socket still has unread data or can take more
+    // data to send, and we only wait for new events if no node has any pending work.
+    epoll_event events[1024];
+
+    // wakeupSelectNeeded was already set before the previous round serviced the nodes, so that we also get woken up
+    // for data which was pushed after we checked the node's send queue
+    int nEvents = epoll_wait(epollFd, events, ARRAYLEN(events), fSocketDataPending ? 0 : SELECT_TIMEOUT_MILLISECONDS);
+    wakeupSelectNeeded = false;
+    if (interruptNet)
+        return;
+
+    if (nEvents < 0)
+    {
+        if (errno != EINTR) {
+            LogPrintf("socket epoll_wait error %s\n", NetworkErrorString(errno));
+        }
+        nEvents = 0;
+        if (!interruptNet.sleep_for(std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS)))
+            return;
+    }
+
+    for (int i = 0; i < nEvents; i++) {
+        auto& e = events[i];
+        if (e.data.ptr == nullptr) {
+            // drain the wakeup eventfd
+            LogPrint("net", "woke up epoll_wait()\n");
+            uint64_t buf;
+            if (read(wakeupEventFd, &buf, sizeof(buf)) != sizeof(buf)) {
+                LogPrint("net", "read from wakeupEventFd failed\n");
             }
-            if (recvSet || errorSet)
-            {
-                {
-                    {
-                        // typical socket buffer is 8K-64K
-                        char pchBuf[0x10000];
-                        int nBytes = 0;
-                        {
-                            LOCK(pnode->cs_hSocket);
-                            if (pnode->hSocket == INVALID_SOCKET)
-                                continue;
-                            nBytes = recv(pnode->hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
-                        }
-                        if (nBytes > 0)
-                        {
-                            bool notify = false;
-                            if (!pnode->ReceiveMsgBytes(pchBuf, nBytes, notify))
-                                pnode->CloseSocketDisconnect();
-                            RecordBytesRecv(nBytes);
-                            if (notify) {
-                                size_t nSizeAdded = 0;
-                                auto it(pnode->vRecvMsg.begin());
-                                for (; it != pnode->vRecvMsg.end(); ++it) {
-                                    if (!it->complete())
-                                        break;
-                                    nSizeAdded += it->vRecv.size() + CMessageHeader::HEADER_SIZE;
-                                }
-                                {
-                                    LOCK(pnode->cs_vProcessMsg);
-                                    pnode->vProcessMsg.splice(pnode->vProcessMsg.end(), pnode->vRecvMsg, pnode->vRecvMsg.begin(), it);
-                                    pnode->nProcessQueueSize += nSizeAdded;
-                                    pnode->fPauseRecv = pnode->nProcessQueueSize > nReceiveFloodSize;
-                                }
-                                WakeMessageHandler();
-                            }
-                        }
-                        else if (nBytes == 0)
-                        {
-                            // socket closed gracefully
-                            if (!pnode->fDisconnect)
-                                LogPrint("net", "socket closed\n");
-                            pnode->CloseSocketDisconnect();
-                        }
-                        else if (nBytes < 0)
-                        {
-                            // error
-                            int nErr = WSAGetLastError();
-                            if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
-                            {
-                                if (!pnode->fDisconnect)
-                                    LogPrintf("socket recv error %s\n", NetworkErrorString(nErr));
-                                pnode->CloseSocketDisconnect();
-                            }
-                        }
-                    }
-                }
+            continue;
+        }
+
+        const ListenSocket* pListenSocket = nullptr;
+        BOOST_FOREACH(const ListenSocket& hListenSocket, vhListenSocket) {
+            if (e.data.ptr == &hListenSocket) {
+                pListenSocket = &hListenSocket;
+                break;
             }
+        }
+        if (pListenSocket != nullptr) {
+            AcceptConnection(*pListenSocket);
+            continue;
+        }
 
-            //
-            // Send
-            //
-            if (sendSet)
-            {
-                LOCK(pnode->cs_vSend);
+        // Nodes are only deleted by this thread and only after their sockets got closed, which also removes them
+        // from the epoll set. So this can't be a dangling pointer.
+        CNode* pnode = static_cast<CNode*>(e.data.ptr);
+        if (e.events & (EPOLLIN | EPOLLERR | EPOLLHUP)) {
+            pnode->fHasRecvData = true;
+        }
+        if (e.events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+            LOCK(pnode->cs_vSend);
+            pnode->fCanSendData = true;
+        }
+    }
+
+    //
+    // Service each socket
+    //
+    wakeupSelectNeeded = true;
+    fSocketDataPending = false;
+    std::vector<CNode*> vNodesCopy = CopyNodeVector();
+    BOOST_FOREACH(CNode* pnode, vNodesCopy)
+    {
+        if (interruptNet)
+            return;
+
+        // Same logic as in SocketHandlerSelect: first drain the write buffer before receiving more
+        bool fPendingSend;
+        {
+            LOCK(pnode->cs_vSend);
+            if (!pnode->vSendMsg.empty() && pnode->fCanSendData) {
                 size_t nBytes = SocketSendData(pnode);
                 if (nBytes) {
                     RecordBytesSent(nBytes);
                 }
             }
+            fPendingSend = !pnode->vSendMsg.empty();
+        }
 
-            //
-            // Inactivity checking
-            //
-            int64_t nTime = GetSystemTimeInSeconds();
-            if (nTime - pnode->nTimeConnected > 60)
-            {
-                if (pnode->nLastRecv == 0 || pnode->nLastSend == 0)
-                {
-                    LogPrint("net", "socket no message in first 60 seconds, %d %d from %d\n", pnode->nLastRecv != 0, pnode->nLastSend != 0, pnode->id);
-                    pnode->fDisconnect = true;
-                }
-                else if (nTime - pnode->nLastSend > TIMEOUT_INTERVAL)
-                {
-                    LogPrintf("socket sending timeout: %is\n", nTime - pnode->nLastSend);
-                    pnode->fDisconnect = true;
-                }
-                else if (nTime - pnode->nLastRecv > (pnode->nVersion > BIP0031_VERSION ? TIMEOUT_INTERVAL : 90*60))
-                {
-                    LogPrintf("socket receive timeout: %is\n", nTime - pnode->nLastRecv);
-                    pnode->fDisconnect = true;
-                }
-                else if (pnode->nPingNonceSent && pnode->nPingUsecStart + TIMEOUT_INTERVAL * 1000000 < GetTimeMicros())
-                {
-                    LogPrintf("ping timeout: %fs\n", 0.000001 * (GetTimeMicros() - pnode->nPingUsecStart));
-                    pnode->fDisconnect = true;
-                }
-                else if (!pnode->fSuccessfullyConnected)
-                {
-                    LogPrintf("version handshake timeout from %d\n", pnode->id);
-                    pnode->fDisconnect = true;
-                }
-            }
+        if (!fPendingSend && pnode->fHasRecvData && !pnode->fPauseRecv) {
+            // We won't get another event until the socket is drained, so remember that more data might be waiting
+            pnode->fHasRecvData = SocketRecvData(pnode);
+            fSocketDataPending |= pnode->fHasRecvData;
         }
-        ReleaseNodeVector(vNodesCopy);
+
+        InactivityCheck(pnode);
+    }
+    ReleaseNodeVector(vNodesCopy);
+}
+#endif
+
+void CConnman::RegisterEvents(CNode* pnode)
+{
+#ifdef USE_EPOLL
+    if (socketEventsMode != SOCKETEVENTS_EPOLL) {
+        return;
+    }
+
+    LOCK(pnode->cs_hSocket);
+    assert(pnode->hSocket != INVALID_SOCKET);
+
+    epoll_event e;
+    e.events = EPOLLIN | EPOLLOUT | EPOLLET;
+    e.data.ptr = pnode;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, pnode->hSocket, &e) != 0) {
+        LogPrintf("%s -- epoll_ctl failed for peer=%d: %s\n", __func__, pnode->id, NetworkErrorString(errno));
+        pnode->fDisconnect = true;
+    }
+#endif
+}
+
+void CConnman::ThreadSocketHandler()
+{
+    while (!interruptNet)
+    {
+        DisconnectNodes();
+        NotifyNumConnectionsChanged();
+
+#ifdef USE_EPOLL
+        if (socketEventsMode == SOCKETEVENTS_EPOLL) {
+            SocketHandlerEpoll();
+            continue;
+        }
+#endif
+        SocketHandlerSelect();
     }
 }
 
 void CConnman::WakeMessageHandler()
 {
+    for (size_t i = 0; i < nMessageHandlerThreads; i++) {
+        auto& handler = messageHandlers[i];
+        {
+            std::lock_guard<std::mutex> lock(handler.mutexMsgProc);
+            handler.fMsgProcWake = true;
+        }
+        handler.condMsgProc.notify_one();
+    }
+}
+
+void CConnman::WakeMessageHandler(const CNode* pnode)
+{
+    if (nMessageHandlerThreads == 0) {
+        return;
+    }
+    auto& handler = messageHandlers[GetMessageHandlerThread(pnode)];
     {
-        std::lock_guard<std::mutex> lock(mutexMsgProc);
-        fMsgProcWake = true;
+        std::lock_guard<std::mutex> lock(handler.mutexMsgProc);
+        handler.fMsgProcWake = true;
     }
-    condMsgProc.notify_one();
+    handler.condMsgProc.notify_one();
 }
 
 void CConnman::WakeSelect()
 {
+    // Reset the flag before actually waking up the socket handler, as it might otherwise already be waiting again (with
+    // the flag set) by the time we reset it, causing the next wakeup to be missed
+    wakeupSelectNeeded = false;
+
+#ifdef USE_EPOLL
+    if (socketEventsMode == SOCKETEVENTS_EPOLL) {
+        if (wakeupEventFd == -1) {
+            return;
+        }
+
+        LogPrint("net", "waking up epoll_wait()\n");
+
+        uint64_t buf = 1;
+        if (write(wakeupEventFd, &buf, sizeof(buf)) != sizeof(buf)) {
+            LogPrint("net", "write to wakeupEventFd failed\n");
+        }
+        return;
+    }
+#endif
+
 #ifndef WIN32
     if (wakeupPipe[1] == -1) {
         return;
@@ -1526,8 +1715,6 @@ void CConnman::WakeSelect()
         LogPrint("net", "write to wakeupPipe failed\n");
     }
 #endif
-
-    wakeupSelectNeeded = false;
 }
 
 
@@ -2177,6 +2364,7 @@ bool CConnman::OpenNetworkConnection(const CAddress& addrConnect, bool fCountFai
     {
         LOCK(cs_vNodes);
         vNodes.push_back(pnode);
+        RegisterEvents(pnode);
     }
 
     return true;
@@ -2186,24 +2374,38 @@ bool CConnman::OpenMasternodeConnection(const CAddress &addrConnect) {
     return OpenNetworkConnection(addrConnect, false, NULL, NULL, false, false, false, true);
 }
 
-void CConnman::ThreadMessageHandler()
+size_t CConnman::GetMessageHandlerThread(const CNode* pnode) const
 {
+    return (size_t)pnode->GetId() % nMessageHandlerThreads;
+}
+
+void CConnman::ThreadMessageHandler(size_t nThread)
+{
+    MessageHandlerThread& handler = messageHandlers[nThread];
+
     while (!flagInterruptMsgProc)
     {
         std::vector<CNode*> vNodesCopy = CopyNodeVector();
 
         bool fMoreWork = false;
+        size_t nPeers = 0;
 
         BOOST_FOREACH(CNode* pnode, vNodesCopy)
         {
-            if (pnode->fDisconnect)
+            if (pnode->fDisconnect || GetMessageHandlerThread(pnode) != nThread)
                 continue;
+            nPeers++;
 
             // Receive messages
+            int64_t nTime1 = GetTimeMicros();
+            uint64_t nProcessedMsgs = pnode->nProcessedMsgs;
             bool fMoreNodeWork = GetNodeSignals().ProcessMessages(pnode, *this, flagInterruptMsgProc);
             fMoreWork |= (fMoreNodeWork && !pnode->fPauseSend);
             if (flagInterruptMsgProc)
                 return;
+            int64_t nTime2 = GetTimeMicros();
+            handler.nMessages += pnode->nProcessedMsgs - nProcessedMsgs;
+            handler.nProcessTime += nTime2 - nTime1;
 
             // Send messages
             {
@@ -2212,15 +2414,17 @@ void CConnman::ThreadMessageHandler()
             }
             if (flagInterruptMsgProc)
                 return;
+            handler.nSendTime += GetTimeMicros() - nTime2;
         }
+        handler.nPeers = nPeers;
 
         ReleaseNodeVector(vNodesCopy);
 
-        std::unique_lock<std::mutex> lock(mutexMsgProc);
+        std::unique_lock<std::mutex> lock(handler.mutexMsgProc);
         if (!fMoreWork) {
-            condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this] { return fMsgProcWake; });
+            handler.condMsgProc.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::milliseconds(100), [this, &handler] { return handler.fMsgProcWake || flagInterruptMsgProc; });
         }
-        fMsgProcWake = false;
+        handler.fMsgProcWake = false;
     }
 }
 
@@ -2418,6 +2622,7 @@ CConnman::CConnman(uint64_t nSeed0In, uint64_t nSeed1In) :
     nBestHeight = 0;
     clientInterface = NULL;
     flagInterruptMsgProc = false;
+    socketEventsMode = SOCKETEVENTS_SELECT;
 }
 
 NodeId CConnman::GetNewNodeId()
@@ -2445,6 +2650,8 @@ bool CConnman::Start(CScheduler& scheduler, std::string& strNodeError, Options c
     nMaxOutboundLimit = connOptions.nMaxOutboundLimit;
     nMaxOutboundTimeframe = connOptions.nMaxOutboundTimeframe;
 
+    socketEventsMode = connOptions.socketEventsMode;
+
     SetBestHeight(connOptions.nBestHeight);
 
     clientInterface = connOptions.uiInterface;
@@ -2507,10 +2714,8 @@ bool CConnman::Start(CScheduler& scheduler, std::string& strNodeError, Options c
     interruptNet.reset();
     flagInterruptMsgProc = false;
 
-    {
-        std::unique_lock<std::mutex> lock(mutexMsgProc);
-        fMsgProcWake = false;
-    }
+    // must be set before nodes are added, as it determines which thread handles which node
+    nMessageHandlerThreads = std::max(1, std::min(connOptions.nMessageHandlerThreads, MAX_MSGHANDLER_THREADS));
 
 #ifndef WIN32
     if (pipe(wakeupPipe) != 0) {
@@ -2528,6 +2733,36 @@ bool CConnman::Start(CScheduler& scheduler, std::string& strNodeError, Options c
     }
 #endif
 
+#ifdef USE_EPOLL
+    if (socketEventsMode == SOCKETEVENTS_EPOLL) {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (epollFd == -1) {
+            strNodeError = strprintf("epoll_create1 failed: %s", NetworkErrorString(errno));
+            return false;
+        }
+        wakeupEventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wakeupEventFd == -1) {
+            strNodeError = strprintf("eventfd failed: %s", NetworkErrorString(errno));
+            return false;
+        }
+
+        // the wakeup eventfd and listen sockets are level-triggered, nodes are registered edge-triggered in RegisterEvents
+        epoll_event e;
+        e.events = EPOLLIN;
+        e.data.ptr = nullptr;
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeupEventFd, &e) != 0) {
+            LogPrint("net", "epoll_ctl for wakeupEventFd failed\n");
+        }
+        for (ListenSocket& hListenSocket : vhListenSocket) {
+            e.data.ptr = &hListenSocket;
+            if (epoll_ctl(epollFd, EPOLL_CTL_ADD, hListenSocket.socket, &e) != 0) {
+                strNodeError = strprintf("epoll_ctl for listen socket failed: %s", NetworkErrorString(errno));
+                return false;
+            }
+        }
+    }
+#endif
+
     // Send and receive from sockets, accept connections
     threadSocketHandler = std::thread(&TraceThread<std::function<void()> >, "net", std::function<void()>(std::bind(&CConnman::ThreadSocketHandler, this)));
 
@@ -2547,7 +2782,15 @@ bool CConnman::Start(CScheduler& scheduler, std::string& strNodeError, Options c
     threadOpenMasternodeConnections = std::thread(&TraceThread<std::function<void()> >, "mncon", std::function<void()>(std::bind(&CConnman::ThreadOpenMasternodeConnections, this)));
 
     // Process messages
-    threadMessageHandler = std::thread(&TraceThread<std::function<void()> >, "msghand", std::function<void()>(std::bind(&CConnman::ThreadMessageHandler, this)));
+    for (size_t i = 0; i < nMessageHandlerThreads; i++) {
+        auto& handler = messageHandlers[i];
+        {
+            std::unique_lock<std::mutex> lock(handler.mutexMsgProc);
+            handler.fMsgProcWake = false;
+        }
+        handler.strThreadName = strprintf("msghand.%d", i);
+        handler.thread = std::thread(&TraceThread<std::function<void()> >, handler.strThreadName.c_str(), std::function<void()>(std::bind(&CConnman::ThreadMessageHandler, this, i)));
+    }
 
     // Dump network addresses
     scheduler.scheduleEvery(std::bind(&CConnman::DumpData, this), DUMP_ADDRESSES_INTERVAL * 1000);
@@ -2580,11 +2823,14 @@ void CExplicitNetCleanup::callCleanup()
 
 void CConnman::Interrupt()
 {
-    {
-        std::lock_guard<std::mutex> lock(mutexMsgProc);
-        flagInterruptMsgProc = true;
+    flagInterruptMsgProc = true;
+    for (auto& handler : messageHandlers) {
+        {
+            // make sure the handler is either already waiting or sees the flag before it starts to wait
+            std::lock_guard<std::mutex> lock(handler.mutexMsgProc);
+        }
+        handler.condMsgProc.notify_all();
     }
-    condMsgProc.notify_all();
 
     interruptNet();
     InterruptSocks5(true);
@@ -2611,8 +2857,10 @@ void CConnman::Interrupt()
 
 void CConnman::Stop()
 {
-    if (threadMessageHandler.joinable())
-        threadMessageHandler.join();
+    for (auto& handler : messageHandlers) {
+        if (handler.thread.joinable())
+            handler.thread.join();
+    }
     if (threadOpenMasternodeConnections.joinable())
         threadOpenMasternodeConnections.join();
     if (threadOpenConnections.joinable())
@@ -2660,6 +2908,12 @@ void CConnman::Stop()
     if (wakeupPipe[1] != -1) close(wakeupPipe[1]);
     wakeupPipe[0] = wakeupPipe[1] = -1;
 #endif
+
+#ifdef USE_EPOLL
+    if (wakeupEventFd != -1) close(wakeupEventFd);
+    if (epollFd != -1) close(epollFd);
+    wakeupEventFd = epollFd = -1;
+#endif
 }
 
 void CConnman::DeleteNode(CNode* pnode)
@@ -2846,6 +3100,16 @@ size_t CConnman::GetNodeCount(NumConnections flags)
     return nNum;
 }
 
+void CConnman::GetMessageHandlerStats(std::vector<MessageHandlerStats>& vstats) const
+{
+    vstats.clear();
+    vstats.reserve(nMessageHandlerThreads);
+    for (size_t i = 0; i < nMessageHandlerThreads; i++) {
+        auto& handler = messageHandlers[i];
+        vstats.push_back({(int)i, handler.nPeers, handler.nMessages, handler.nProcessTime, handler.nSendTime});
+    }
+}
+
 void CConnman::GetNodeStats(std::vector<CNodeStats>& vstats)
 {
     vstats.clear();
@@ -3136,7 +3400,10 @@ CNode::CNode(NodeId idIn, ServiceFlags nLocalServicesIn, int nMyStartingHeightIn
     nMinPingUsecTime = std::numeric_limits<int64_t>::max();
     fPauseRecv = false;
     fPauseSend = false;
+    fHasRecvData = false;
+    fCanSendData = false;
     nProcessQueueSize = 0;
+    nProcessedMsgs = 0;
 
     BOOST_FOREACH(const std::string &msg, getAllNetMessageTypes())
         mapRecvBytesPerMsgCmd[msg] = 0;
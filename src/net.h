@@ -23,6 +23,7 @@
 #include "threadinterrupt.h"
 #include "consensus/params.h"
 
+#include <array>
 #include <atomic>
 #include <deque>
 #include <stdint.h>
@@ -93,6 +94,16 @@ static const bool DEFAULT_UPNP = USE_UPNP;
 #else
 static const bool DEFAULT_UPNP = false;
 #endif
+/** -msghandlerthreads default */
+static const int DEFAULT_MSGHANDLER_THREADS = 2;
+/** Maximum number of message handler threads */
+static const int MAX_MSGHANDLER_THREADS = 16;
+/** -socketevents default */
+#ifdef USE_EPOLL
+static const std::string DEFAULT_SOCKETEVENTS = "epoll";
+#else
+static const std::string DEFAULT_SOCKETEVENTS = "select";
+#endif
 /** The maximum number of entries in mapAskFor */
 static const size_t MAPASKFOR_MAX_SZ = MAX_INV_SZ;
 /** The maximum number of entries in setAskFor (larger due to getdata latency)*/
@@ -147,6 +158,11 @@ class CConnman
 {
 public:
 
+    enum SocketEventsMode {
+        SOCKETEVENTS_SELECT = 0,
+        SOCKETEVENTS_EPOLL = 1,
+    };
+
     enum NumConnections {
         CONNECTIONS_NONE = 0,
         CONNECTIONS_IN = (1U << 0),
@@ -168,6 +184,17 @@ public:
         unsigned int nReceiveFloodSize = 0;
         uint64_t nMaxOutboundTimeframe = 0;
         uint64_t nMaxOutboundLimit = 0;
+        SocketEventsMode socketEventsMode = SOCKETEVENTS_SELECT;
+        int nMessageHandlerThreads = 1;
+    };
+
+    struct MessageHandlerStats
+    {
+        int nThread;
+        size_t nPeers;
+        uint64_t nMessages;
+        int64_t nProcessTime; // microseconds spent in ProcessMessages
+        int64_t nSendTime; // microseconds spent in SendMessages
     };
     CConnman(uint64_t seed0, uint64_t seed1);
     ~CConnman();
@@ -381,6 +408,7 @@ public:
 
     size_t GetNodeCount(NumConnections num);
     void GetNodeStats(std::vector<CNodeStats>& vstats);
+    void GetMessageHandlerStats(std::vector<MessageHandlerStats>& vstats) const;
     bool DisconnectNode(const std::string& node);
     bool DisconnectNode(NodeId id);
 
@@ -423,6 +451,7 @@ public:
     unsigned int GetReceiveFloodSize() const;
 
     void WakeMessageHandler();
+    void WakeMessageHandler(const CNode* pnode);
     void WakeSelect();
 
 private:
@@ -436,8 +465,18 @@ private:
     void ThreadOpenAddedConnections();
     void ProcessOneShot();
     void ThreadOpenConnections();
-    void ThreadMessageHandler();
+    void ThreadMessageHandler(size_t nThread);
+    size_t GetMessageHandlerThread(const CNode* pnode) const;
     void AcceptConnection(const ListenSocket& hListenSocket);
+    void DisconnectNodes();
+    void NotifyNumConnectionsChanged();
+    void InactivityCheck(CNode* pnode);
+    bool SocketRecvData(CNode* pnode);
+    void SocketHandlerSelect();
+#ifdef USE_EPOLL
+    void SocketHandlerEpoll();
+#endif
+    void RegisterEvents(CNode* pnode);
     void ThreadSocketHandler();
     void ThreadDNSAddressSeed();
     void ThreadOpenMasternodeConnections();
@@ -533,11 +572,30 @@ private:
     /** SipHasher seeds for deterministic randomness */
     const uint64_t nSeed0, nSeed1;
 
-    /** flag for waking the message processor. */
-    bool fMsgProcWake;
+    /**
+     * A message handler thread. Each thread owns a disjoint set of nodes (see GetMessageHandlerThread), so that
+     * messages which don't need to be serialized with the rest of the message processing (see ProcessMessages) can be
+     * handled concurrently for different nodes.
+     */
+    struct MessageHandlerThread
+    {
+        std::string strThreadName;
+        std::thread thread;
+
+        /** flag for waking the message processor. */
+        bool fMsgProcWake{false};
+
+        std::condition_variable condMsgProc;
+        std::mutex mutexMsgProc;
 
-    std::condition_variable condMsgProc;
-    std::mutex mutexMsgProc;
+        std::atomic<size_t> nPeers{0};
+        std::atomic<uint64_t> nMessages{0};
+        std::atomic<int64_t> nProcessTime{0};
+        std::atomic<int64_t> nSendTime{0};
+    };
+    // all handlers exist for the lifetime of CConnman, so that they can be woken up before and after the threads run
+    std::array<MessageHandlerThread, MAX_MSGHANDLER_THREADS> messageHandlers;
+    std::atomic<size_t> nMessageHandlerThreads{0};
     std::atomic<bool> flagInterruptMsgProc;
 
     CThreadInterrupt interruptNet;
@@ -548,12 +606,22 @@ private:
 #endif
     std::atomic<bool> wakeupSelectNeeded{false};
 
+    SocketEventsMode socketEventsMode;
+#ifdef USE_EPOLL
+    /** epoll instance with all node and listen sockets registered, only used with -socketevents=epoll */
+    int epollFd{-1};
+    /** an eventfd which replaces wakeupPipe with -socketevents=epoll */
+    int wakeupEventFd{-1};
+    /** true if a node still has unread data in its socket, in which case we must not block in epoll_wait */
+    bool fSocketDataPending{false};
+#endif
+    unsigned int nPrevNodeCount{0};
+
     std::thread threadDNSAddressSeed;
     std::thread threadSocketHandler;
     std::thread threadOpenAddedConnections;
     std::thread threadOpenConnections;
     std::thread threadOpenMasternodeConnections;
-    std::thread threadMessageHandler;
 };
 extern std::unique_ptr<CConnman> g_connman;
 void Discover(boost::thread_group& threadGroup);
@@ -633,6 +701,8 @@ struct LocalServiceInfo {
 extern CCriticalSection cs_mapLocalHost;
 extern std::map<CNetAddr, LocalServiceInfo> mapLocalHost;
 typedef std::map<std::string, uint64_t> mapMsgCmdSize; //command, total bytes
+/** Used instead of the command for messages with an unknown command */
+const static std::string NET_MESSAGE_COMMAND_OTHER = "*other*";
 
 class CNodeStats
 {
@@ -731,6 +801,7 @@ public:
     CCriticalSection cs_vProcessMsg;
     std::list<CNetMessage> vProcessMsg;
     size_t nProcessQueueSize;
+    std::atomic<uint64_t> nProcessedMsgs;
 
     CCriticalSection cs_sendProcessing;
 
@@ -781,6 +852,10 @@ public:
 
     std::atomic_bool fPauseRecv;
     std::atomic_bool fPauseSend;
+    // Readiness as reported by edge-triggered epoll. Only used with -socketevents=epoll, where we won't get notified
+    // again until the socket was drained (recv) or became unwritable (send)
+    bool fHasRecvData; // only accessed by the socket handler thread
+    bool fCanSendData; // protected by cs_vSend
 protected:
 
     mapMsgCmdSize mapSendBytesPerMsgCmd;
@@ -23,10 +23,12 @@
 #include "primitives/block.h"
 #include "primitives/transaction.h"
 #include "random.h"
+#include "saltedhasher.h"
 #include "tinyformat.h"
 #include "txdb.h"
 #include "txmempool.h"
 #include "ui_interface.h"
+#include "unordered_lru_cache.h"
 #include "util.h"
 #include "utilmoneystr.h"
 #include "utilstrencodings.h"
@@ -56,6 +58,8 @@
 
 #include <boost/thread.hpp>
 
+#include <unordered_map>
+
 #if defined(NDEBUG)
 # error "Beenode Core cannot be compiled without assertions."
 #endif
@@ -89,6 +93,143 @@ static std::vector<std::pair<uint256, CTransactionRef>> vExtraTxnForCompact GUAR
 
 static const uint64_t RANDOMIZER_ID_ADDRESS_RELAY = 0x3cac0035b5866b90ULL; // SHA256("main address relay")[0:8]
 
+/**
+ * Messages are processed by multiple message handler threads (see CConnman::ThreadMessageHandler), but most of the
+ * message processing code assumes that it's the only one modifying chain, mempool and node state. So all messages are
+ * serialized through this lock, except the ones marked as concurrent in the message dispatch table below. These are only
+ * handled by subsystems with their own locking.
+ * GETDATA responses and SendMessages are serialized as well. This way, LLMQ gossip (sig shares and DKG) doesn't delay
+ * the processing of blocks and transactions.
+ */
+static CCriticalSection cs_serialMessages;
+
+typedef void (*MessageHandlerFunc)(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
+
+/**
+ * Entry of the message dispatch table. Messages of the Beenode specific subsystems are directly dispatched to the
+ * handler of the subsystem, all others (handler == nullptr) are processed in ProcessMessage.
+ */
+struct CMessageDispatchEntry
+{
+    MessageHandlerFunc handler{nullptr};
+    // processed without holding cs_serialMessages
+    bool fConcurrent{false};
+
+    std::atomic<uint64_t> nMessages{0};
+    std::atomic<uint64_t> nBytes{0};
+    std::atomic<int64_t> nCPUTime{0};
+};
+
+class CMessageDispatchTable
+{
+private:
+    // never modified after construction, so lookups don't need any locking
+    std::unordered_map<std::string, CMessageDispatchEntry> mapEntries;
+
+public:
+    CMessageDispatchTable();
+
+    CMessageDispatchEntry& Get(const std::string& strCommand);
+    void GetStats(std::map<std::string, CMessageStats>& mapStats) const;
+
+private:
+    void SetHandler(const std::vector<std::string>& vCommands, MessageHandlerFunc handler, bool fConcurrent);
+};
+
+CMessageDispatchTable::CMessageDispatchTable()
+{
+    for (const auto& strCommand : getAllNetMessageTypes()) {
+        mapEntries[strCommand];
+    }
+    mapEntries[NET_MESSAGE_COMMAND_OTHER];
+
+    SetHandler({NetMsgType::DSACCEPT, NetMsgType::DSVIN, NetMsgType::DSFINALTX, NetMsgType::DSSIGNFINALTX,
+                NetMsgType::DSCOMPLETE, NetMsgType::DSSTATUSUPDATE, NetMsgType::DSQUEUE},
+        [](CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman) {
+#ifdef ENABLE_WALLET
+            privateSendClient.ProcessMessage(pfrom, strCommand, vRecv, connman);
+#endif // ENABLE_WALLET
+            privateSendServer.ProcessMessage(pfrom, strCommand, vRecv, connman);
+        }, false);
+    SetHandler({NetMsgType::TXLOCKVOTE},
+        [](CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman) {
+            instantsend.ProcessMessage(pfrom, strCommand, vRecv, connman);
+        }, false);
+    SetHandler({NetMsgType::SPORK, NetMsgType::GETSPORKS},
+        [](CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman) {
+            sporkManager.ProcessSpork(pfrom, strCommand, vRecv, connman);
+        }, true);
+    SetHandler({NetMsgType::SYNCSTATUSCOUNT},
+        [](CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman) {
+            masternodeSync.ProcessMessage(pfrom, strCommand, vRecv);
+        }, false);
+    SetHandler({NetMsgType::MNAUTH},
+        [](CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman) {
+            CMNAuth::ProcessMessage(pfrom, strCommand, vRecv, connman);
+        }, true);
+    SetHandler({NetMsgType::QFCOMMITMENT},
+        [](CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman) {
+            llmq::quorumBlockProcessor->ProcessMessage(pfrom, strCommand, vRecv, connman);
+        }, false);
+    SetHandler({NetMsgType::QCONTRIB, NetMsgType::QCOMPLAINT, NetMsgType::QJUSTIFICATION, NetMsgType::QPCOMMITMENT,
+                NetMsgType::QWATCH},
+        [](CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman) {
+            llmq::quorumDKGSessionManager->ProcessMessage(pfrom, strCommand, vRecv, connman);
+        }, true);
+    SetHandler({NetMsgType::QSIGSESANN, NetMsgType::QSIGSHARESINV, NetMsgType::QGETSIGSHARES, NetMsgType::QBSIGSHARES},
+        [](CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman) {
+            llmq::quorumSigSharesManager->ProcessMessage(pfrom, strCommand, vRecv, connman);
+        }, true);
+    SetHandler({NetMsgType::QSIGREC},
+        [](CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman) {
+            llmq::quorumSigningManager->ProcessMessage(pfrom, strCommand, vRecv, connman);
+        }, false);
+    SetHandler({NetMsgType::CLSIG},
+        [](CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman) {
+            llmq::chainLocksHandler->ProcessMessage(pfrom, strCommand, vRecv, connman);
+        }, false);
+    SetHandler({NetMsgType::ISLOCK},
+        [](CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman) {
+            llmq::quorumInstantSendManager->ProcessMessage(pfrom, strCommand, vRecv, connman);
+        }, false);
+}
+
+void CMessageDispatchTable::SetHandler(const std::vector<std::string>& vCommands, MessageHandlerFunc handler, bool fConcurrent)
+{
+    for (const auto& strCommand : vCommands) {
+        auto& entry = mapEntries.at(strCommand);
+        entry.handler = handler;
+        entry.fConcurrent = fConcurrent;
+    }
+}
+
+CMessageDispatchEntry& CMessageDispatchTable::Get(const std::string& strCommand)
+{
+    auto it = mapEntries.find(strCommand);
+    if (it == mapEntries.end()) {
+        return mapEntries.at(NET_MESSAGE_COMMAND_OTHER);
+    }
+    return it->second;
+}
+
+void CMessageDispatchTable::GetStats(std::map<std::string, CMessageStats>& mapStats) const
+{
+    mapStats.clear();
+    for (const auto& p : mapEntries) {
+        auto& stats = mapStats[p.first];
+        stats.nMessages = p.second.nMessages;
+        stats.nBytes = p.second.nBytes;
+        stats.nCPUTime = p.second.nCPUTime;
+    }
+}
+
+static CMessageDispatchTable& GetMessageDispatchTable()
+{
+    // getAllNetMessageTypes() is not safe to use during static initialization
+    static CMessageDispatchTable messageDispatchTable;
+    return messageDispatchTable;
+}
+
 /// Age after which a stale block will no longer be served if requested as
 /// protection against fingerprinting. Set to one month, denominated in seconds.
 static const int STALE_RELAY_AGE_LIMIT = 30 * 24 * 60 * 60;
@@ -609,6 +750,11 @@ bool GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats) {
     return true;
 }
 
+void GetMessageStats(std::map<std::string, CMessageStats>& mapStats)
+{
+    GetMessageDispatchTable().GetStats(mapStats);
+}
+
 void RegisterNodeSignals(CNodeSignals& nodeSignals)
 {
     nodeSignals.ProcessMessages.connect(&ProcessMessages);
@@ -845,6 +991,28 @@ static std::shared_ptr<const CBlock> most_recent_block;
 static std::shared_ptr<const CBlockHeaderAndShortTxIDs> most_recent_compact_block;
 static uint256 most_recent_block_hash;
 
+/**
+ * Recently served blocks as they are stored on disk. Peers in IBD tend to request the same historical blocks, which
+ * are then read from disk only once. Protected by cs_main.
+ */
+static unordered_lru_cache<uint256, std::shared_ptr<const std::vector<unsigned char>>, StaticSaltedHasher, 16, 24> rawBlockCache;
+
+static std::shared_ptr<const std::vector<unsigned char>> GetRawBlock(const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs_main);
+
+    std::shared_ptr<const std::vector<unsigned char>> pblockData;
+    if (rawBlockCache.get(pindex->GetBlockHash(), pblockData)) {
+        return pblockData;
+    }
+
+    auto pblockDataRead = std::make_shared<std::vector<unsigned char>>();
+    if (!ReadRawBlockFromDisk(*pblockDataRead, pindex, Params().MessageStart()))
+        assert(!"cannot load block from disk");
+    rawBlockCache.insert(pindex->GetBlockHash(), pblockDataRead);
+    return pblockDataRead;
+}
+
 void PeerLogicValidation::NewPoWValidBlock(const CBlockIndex *pindex, const std::shared_ptr<const CBlock>& pblock) {
     std::shared_ptr<const CBlockHeaderAndShortTxIDs> pcmpctblock = std::make_shared<const CBlockHeaderAndShortTxIDs> (*pblock);
     const CNetMsgMaker msgMaker(PROTOCOL_VERSION);
@@ -1128,8 +1296,12 @@ void static ProcessGetBlockData(CNode* pfrom, const Consensus::Params& consensus
     if (send && (mi->second->nStatus & BLOCK_HAVE_DATA))
     {
         std::shared_ptr<const CBlock> pblock;
+        std::shared_ptr<const std::vector<unsigned char>> pblockData;
         if (a_recent_block && a_recent_block->GetHash() == (*mi).second->GetBlockHash()) {
             pblock = a_recent_block;
+        } else if (inv.type == MSG_BLOCK) {
+            // Send block from disk as it is, without deserializing and serializing it again
+            pblockData = GetRawBlock((*mi).second);
         } else {
             // Send block from disk
             std::shared_ptr<CBlock> pblockRead = std::make_shared<CBlock>();
@@ -1137,8 +1309,16 @@ void static ProcessGetBlockData(CNode* pfrom, const Consensus::Params& consensus
                 assert(!"cannot load block from disk");
             pblock = pblockRead;
         }
-        if (inv.type == MSG_BLOCK)
-            connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, *pblock));
+        if (inv.type == MSG_BLOCK) {
+            if (pblockData) {
+                CSerializedNetMsg msg;
+                msg.command = NetMsgType::BLOCK;
+                msg.data = *pblockData;
+                connman.PushMessage(pfrom, std::move(msg));
+            } else {
+                connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::BLOCK, *pblock));
+            }
+        }
         else if (inv.type == MSG_FILTERED_BLOCK)
         {
             bool sendMerkleBlock = false;
@@ -1690,6 +1870,12 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
         return false;
     }
 
+    else if (MessageHandlerFunc handler = GetMessageDispatchTable().Get(strCommand).handler)
+    {
+        // one of the Beenode specific extensions
+        handler(pfrom, strCommand, vRecv, connman);
+    }
+
     else if (strCommand == NetMsgType::ADDR)
     {
         std::vector<CAddress> vAddr;
@@ -3010,38 +3196,8 @@ bool static ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStr
     }
 
     else {
-        bool found = false;
-        const std::vector<std::string> &allMessages = getAllNetMessageTypes();
-        BOOST_FOREACH(const std::string msg, allMessages) {
-            if(msg == strCommand) {
-                found = true;
-                break;
-            }
-        }
-
-        if (found)
-        {
-            //probably one the extensions
-#ifdef ENABLE_WALLET
-            privateSendClient.ProcessMessage(pfrom, strCommand, vRecv, connman);
-#endif // ENABLE_WALLET
-            privateSendServer.ProcessMessage(pfrom, strCommand, vRecv, connman);
-            instantsend.ProcessMessage(pfrom, strCommand, vRecv, connman);
-            sporkManager.ProcessSpork(pfrom, strCommand, vRecv, connman);
-            masternodeSync.ProcessMessage(pfrom, strCommand, vRecv);
-            CMNAuth::ProcessMessage(pfrom, strCommand, vRecv, connman);
-            llmq::quorumBlockProcessor->ProcessMessage(pfrom, strCommand, vRecv, connman);
-            llmq::quorumDKGSessionManager->ProcessMessage(pfrom, strCommand, vRecv, connman);
-            llmq::quorumSigSharesManager->ProcessMessage(pfrom, strCommand, vRecv, connman);
-            llmq::quorumSigningManager->ProcessMessage(pfrom, strCommand, vRecv, connman);
-            llmq::chainLocksHandler->ProcessMessage(pfrom, strCommand, vRecv, connman);
-            llmq::quorumInstantSendManager->ProcessMessage(pfrom, strCommand, vRecv, connman);
-        }
-        else
-        {
-            // Ignore unknown commands for extensibility
-            LogPrint("net", "Unknown command \"%s\" from peer=%d\n", SanitizeString(strCommand), pfrom->id);
-        }
+        // Ignore unknown commands for extensibility
+        LogPrint("net", "Unknown command \"%s\" from peer=%d\n", SanitizeString(strCommand), pfrom->id);
     }
 
     return true;
@@ -3090,8 +3246,10 @@ bool ProcessMessages(CNode* pfrom, CConnman& connman, const std::atomic<bool>& i
     //
     bool fMoreWork = false;
 
-    if (!pfrom->vRecvGetData.empty())
+    if (!pfrom->vRecvGetData.empty()) {
+        LOCK(cs_serialMessages);
         ProcessGetData(pfrom, chainparams.GetConsensus(), connman, interruptMsgProc);
+    }
 
     if (pfrom->fDisconnect)
         return false;
@@ -3111,6 +3269,7 @@ bool ProcessMessages(CNode* pfrom, CConnman& connman, const std::atomic<bool>& i
             // Just take one message
             msgs.splice(msgs.begin(), pfrom->vProcessMsg, pfrom->vProcessMsg.begin());
             pfrom->nProcessQueueSize -= msgs.front().vRecv.size() + CMessageHeader::HEADER_SIZE;
+            pfrom->nProcessedMsgs++;
             pfrom->fPauseRecv = pfrom->nProcessQueueSize > connman.GetReceiveFloodSize();
             fMoreWork = !pfrom->vProcessMsg.empty();
         }
@@ -3150,9 +3309,16 @@ bool ProcessMessages(CNode* pfrom, CConnman& connman, const std::atomic<bool>& i
 
         // Process message
         bool fRet = false;
+        auto& dispatchEntry = GetMessageDispatchTable().Get(strCommand);
+        int64_t nTimeStart = GetThreadCPUTimeMicros();
         try
         {
-            fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc);
+            if (dispatchEntry.fConcurrent) {
+                fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc);
+            } else {
+                LOCK(cs_serialMessages);
+                fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, chainparams, connman, interruptMsgProc);
+            }
             if (interruptMsgProc)
                 return false;
             if (!pfrom->vRecvGetData.empty())
@@ -3184,6 +3350,10 @@ bool ProcessMessages(CNode* pfrom, CConnman& connman, const std::atomic<bool>& i
             PrintExceptionContinue(std::current_exception(), "ProcessMessages()");
         }
 
+        dispatchEntry.nMessages++;
+        dispatchEntry.nBytes += nMessageSize;
+        dispatchEntry.nCPUTime += GetThreadCPUTimeMicros() - nTimeStart;
+
         if (!fRet) {
             LogPrintf("%s(%s, %u bytes) FAILED peer=%d\n", __func__, SanitizeString(strCommand), nMessageSize, pfrom->id);
         }
@@ -3251,6 +3421,8 @@ bool SendMessages(CNode* pto, CConnman& connman, const std::atomic<bool>& interr
             }
         }
 
+        // addresses, inventory and block requests are shared with the processing of other peers' messages
+        LOCK(cs_serialMessages);
         TRY_LOCK(cs_main, lockMain); // Acquire cs_main for IsInitialBlockDownload() and CNodeState()
         if (!lockMain)
             return true;
@@ -51,6 +51,15 @@ struct CNodeStateStats {
 
 /** Get statistics from node state */
 bool GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats);
+
+struct CMessageStats {
+    uint64_t nMessages;
+    uint64_t nBytes;
+    int64_t nCPUTime; // in microseconds
+};
+
+/** Get per command statistics of processed messages (NET_MESSAGE_COMMAND_OTHER for unknown commands) */
+void GetMessageStats(std::map<std::string, CMessageStats>& mapStats);
 /** Increase a node's misbehavior score. */
 void Misbehaving(NodeId nodeid, int howmuch);
 bool IsBanned(NodeId nodeid);
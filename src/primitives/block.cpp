@@ -19,6 +19,21 @@ uint256 CBlockHeader::GetHash() const
     return HashHoneyComb((const char *)vch.data(), (const char *)vch.data() + vch.size());
 }
 
+void HashHoneyCombBatch(const CBlockHeader* headers, size_t n, uint256* out)
+{
+    static const size_t HEADER_SIZE = 80;
+
+    std::vector<unsigned char> vch(HEADER_SIZE * HONEYCOMB_BATCH_LANES);
+    for (size_t pos = 0; pos < n; pos += HONEYCOMB_BATCH_LANES) {
+        const size_t count = std::min(HONEYCOMB_BATCH_LANES, n - pos);
+        CVectorWriter ss(SER_NETWORK, PROTOCOL_VERSION, vch, 0);
+        for (size_t i = 0; i < count; i++) {
+            ss << headers[pos + i];
+        }
+        HashHoneyComb80Batch(vch.data(), count, out[pos].begin());
+    }
+}
+
 std::string CBlock::ToString() const
 {
     std::stringstream s;
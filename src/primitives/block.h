@@ -119,6 +119,10 @@ public:
     std::string ToString() const;
 };
 
+/** Compute the hashes of n block headers at once, equivalent to out[i] = headers[i].GetHash().
+ *  Several headers are interleaved through the HoneyComb facets, see HashHoneyComb80Batch. */
+void HashHoneyCombBatch(const CBlockHeader* headers, size_t n, uint256* out);
+
 
 /** Describes a place in the block chain to another node such that if the
  * other node doesn't have the same branch, it can find a recent common trunk.
@@ -518,7 +518,7 @@ UniValue masternodelist(const JSONRPCRequest& request)
         return (int)pindex->nTime;
     };
 
-    mnList.ForEachMN(false, [&](const CDeterministicMNCPtr& dmn) {
+    auto processMN = [&](const CDeterministicMNCPtr& dmn) {
         std::string strOutpoint = dmn->collateralOutpoint.ToStringShort();
         Coin coin;
         std::string collateralAddressStr = "UNKNOWN";
@@ -615,7 +615,18 @@ UniValue masternodelist(const JSONRPCRequest& request)
             if (strFilter !="" && strOutpoint.find(strFilter) == std::string::npos) return;
             obj.push_back(Pair(strOutpoint, CBitcoinAddress(dmn->pdmnState->keyIDVoting).ToString()));
         }
-    });
+    };
+
+    // A complete payee address can only match MNs paying to exactly this address (it can't be part of an outpoint
+    // as it is not hex), so these can be taken from the payout script index instead of scanning the whole list
+    CBitcoinAddress filterAddress(strFilter);
+    if (strMode == "payee" && filterAddress.IsValid() && strFilter.find_first_not_of("0123456789abcdef-") != std::string::npos) {
+        for (const auto& dmn : mnList.GetMNsByPayoutScript(GetScriptForDestination(filterAddress.Get()))) {
+            processMN(dmn);
+        }
+    } else {
+        mnList.ForEachMN(false, processMN);
+    }
 
     return obj;
 }
@@ -24,6 +24,8 @@
 #include "masternode-sync.h"
 #include "spork.h"
 
+#include "evo/deterministicmns.h"
+
 #include <stdint.h>
 
 #include <boost/assign/list_of.hpp>
@@ -1107,6 +1109,21 @@ static UniValue RPCLockedMemoryInfo()
     return obj;
 }
 
+static UniValue RPCMNListCacheInfo()
+{
+    auto stats = deterministicMNManager->GetCacheStats();
+    UniValue obj(UniValue::VOBJ);
+    obj.push_back(Pair("entries", uint64_t(stats.nEntries)));
+    obj.push_back(Pair("bytes", uint64_t(stats.nMemoryUsage)));
+    obj.push_back(Pair("maxbytes", uint64_t(stats.nMaxMemoryUsage)));
+    obj.push_back(Pair("hits", stats.nHits));
+    obj.push_back(Pair("misses", stats.nMisses));
+    obj.push_back(Pair("replayed_diffs", stats.nReplayedDiffs));
+    obj.push_back(Pair("last_replay_depth", uint64_t(stats.nLastReplayDepth)));
+    obj.push_back(Pair("max_replay_depth", uint64_t(stats.nMaxReplayDepth)));
+    return obj;
+}
+
 UniValue getmemoryinfo(const JSONRPCRequest& request)
 {
     /* Please, avoid using the word "pool" here in the RPC interface or help,
@@ -1125,6 +1142,16 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
             "    \"locked\": xxxxxx,       (numeric) Amount of bytes that succeeded locking. If this number is smaller than total, locking pages failed at some point and key data could be swapped to disk.\n"
             "    \"chunks_used\": xxxxx,   (numeric) Number allocated chunks\n"
             "    \"chunks_free\": xxxxx,   (numeric) Number unused chunks\n"
+            "  },\n"
+            "  \"mnlistcache\": {          (json object) Information about the masternode list cache\n"
+            "    \"entries\": xxxxx,       (numeric) Number of cached lists\n"
+            "    \"bytes\": xxxxx,         (numeric) Estimated number of bytes used (upper bound)\n"
+            "    \"maxbytes\": xxxxx,      (numeric) Maximum number of bytes to use, see -mnlistcachesize\n"
+            "    \"hits\": xxxxx,          (numeric) Number of lookups served from the cache\n"
+            "    \"misses\": xxxxx,        (numeric) Number of lookups which required replaying diffs\n"
+            "    \"replayed_diffs\": xxxxx, (numeric) Total number of diffs replayed\n"
+            "    \"last_replay_depth\": xxx, (numeric) Number of diffs replayed by the last cache miss\n"
+            "    \"max_replay_depth\": xxx,  (numeric) Maximum number of diffs replayed by a single cache miss\n"
             "  }\n"
             "}\n"
             "\nExamples:\n"
@@ -1133,6 +1160,9 @@ UniValue getmemoryinfo(const JSONRPCRequest& request)
         );
     UniValue obj(UniValue::VOBJ);
     obj.push_back(Pair("locked", RPCLockedMemoryInfo()));
+    if (deterministicMNManager) {
+        obj.push_back(Pair("mnlistcache", RPCMNListCacheInfo()));
+    }
     return obj;
 }
 
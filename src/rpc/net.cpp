@@ -375,6 +375,46 @@ UniValue getnettotals(const JSONRPCRequest& request)
     return obj;
 }
 
+UniValue getmessagestats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0)
+        throw std::runtime_error(
+            "getmessagestats\n"
+            "\nReturns statistics about the processing of received P2P messages, grouped by message command.\n"
+            "Only commands which were received at least once are listed.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"command\": {         (string) The message command, \"*other*\" for unknown commands\n"
+            "    \"messages\": n,     (numeric) Number of processed messages\n"
+            "    \"bytes\": n,        (numeric) Total payload size of the processed messages\n"
+            "    \"cputime\": n,      (numeric) CPU time in seconds spent in the message handler threads\n"
+            "  },\n"
+            "  ...\n"
+            "}\n"
+            "\nExamples:\n"
+            + HelpExampleCli("getmessagestats", "")
+            + HelpExampleRpc("getmessagestats", "")
+        );
+    if(!g_connman)
+        throw JSONRPCError(RPC_CLIENT_P2P_DISABLED, "Error: Peer-to-peer functionality missing or disabled");
+
+    std::map<std::string, CMessageStats> mapStats;
+    GetMessageStats(mapStats);
+
+    UniValue ret(UniValue::VOBJ);
+    for (const auto& p : mapStats) {
+        if (p.second.nMessages == 0) {
+            continue;
+        }
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("messages", p.second.nMessages));
+        obj.push_back(Pair("bytes", p.second.nBytes));
+        obj.push_back(Pair("cputime", p.second.nCPUTime * 0.000001));
+        ret.push_back(Pair(p.first, obj));
+    }
+    return ret;
+}
+
 static UniValue GetNetworksInfo()
 {
     UniValue networks(UniValue::VARR);
@@ -424,6 +464,16 @@ UniValue getnetworkinfo(const JSONRPCRequest& request)
             "  ],\n"
             "  \"relayfee\": x.xxxxxxxx,                (numeric) minimum relay fee for transactions in " + CURRENCY_UNIT + "/kB\n"
             "  \"incrementalfee\": x.xxxxxxxx,          (numeric) minimum fee increment for mempool limiting or BIP 125 replacement in " + CURRENCY_UNIT + "/kB\n"
+            "  \"messagehandlers\": [                   (array) information per message handler thread\n"
+            "  {\n"
+            "    \"thread\": n,                         (numeric) the index of the thread\n"
+            "    \"peers\": n,                          (numeric) the number of peers handled by this thread\n"
+            "    \"messages\": n,                       (numeric) the total number of messages processed\n"
+            "    \"processtime\": n,                    (numeric) the total time in seconds spent processing received messages\n"
+            "    \"sendtime\": n                        (numeric) the total time in seconds spent preparing messages to send\n"
+            "  }\n"
+            "  ,...\n"
+            "  ],\n"
             "  \"localaddresses\": [                    (array) list of local addresses\n"
             "  {\n"
             "    \"address\": \"xxxx\",                 (string) network address\n"
@@ -455,6 +505,21 @@ UniValue getnetworkinfo(const JSONRPCRequest& request)
     obj.push_back(Pair("networks",      GetNetworksInfo()));
     obj.push_back(Pair("relayfee",      ValueFromAmount(::minRelayTxFee.GetFeePerK())));
     obj.push_back(Pair("incrementalfee", ValueFromAmount(::incrementalRelayFee.GetFeePerK())));
+    if (g_connman) {
+        std::vector<CConnman::MessageHandlerStats> vstats;
+        g_connman->GetMessageHandlerStats(vstats);
+        UniValue messageHandlers(UniValue::VARR);
+        for (const auto& stats : vstats) {
+            UniValue rec(UniValue::VOBJ);
+            rec.push_back(Pair("thread", stats.nThread));
+            rec.push_back(Pair("peers", (uint64_t)stats.nPeers));
+            rec.push_back(Pair("messages", stats.nMessages));
+            rec.push_back(Pair("processtime", stats.nProcessTime * 0.000001));
+            rec.push_back(Pair("sendtime", stats.nSendTime * 0.000001));
+            messageHandlers.push_back(rec);
+        }
+        obj.push_back(Pair("messagehandlers", messageHandlers));
+    }
     UniValue localAddresses(UniValue::VARR);
     {
         LOCK(cs_mapLocalHost);
@@ -618,6 +683,7 @@ static const CRPCCommand commands[] =
     { "network",            "getaddednodeinfo",       &getaddednodeinfo,       true,  {"node"} },
     { "network",            "getnettotals",           &getnettotals,           true,  {} },
     { "network",            "getnetworkinfo",         &getnetworkinfo,         true,  {} },
+    { "network",            "getmessagestats",        &getmessagestats,        true,  {} },
     { "network",            "setban",                 &setban,                 true,  {"subnet", "command", "bantime", "absolute"} },
     { "network",            "listbanned",             &listbanned,             true,  {} },
     { "network",            "clearbanned",            &clearbanned,            true,  {} },
@@ -8,9 +8,12 @@
 
 #include "llmq/quorums.h"
 #include "llmq/quorums_blockprocessor.h"
+#include "llmq/quorums_chainlocks.h"
 #include "llmq/quorums_debug.h"
 #include "llmq/quorums_dkgsession.h"
 #include "llmq/quorums_signing.h"
+#include "llmq/quorums_signing_shares.h"
+#include "llmq/quorums_utils.h"
 
 void quorum_list_help()
 {
@@ -189,6 +192,129 @@ UniValue quorum_dkgstatus(const JSONRPCRequest& request)
     return ret;
 }
 
+void quorum_memberscache_help()
+{
+    throw std::runtime_error(
+            "quorum memberscache\n"
+            "Return hit and miss counters of the quorum members cache.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"hits\": n,                (numeric) Lookups answered from the cache\n"
+            "  \"misses\": n               (numeric) Lookups which had to calculate the quorum\n"
+            "}\n"
+    );
+}
+
+UniValue quorum_memberscache(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1) {
+        quorum_memberscache_help();
+    }
+
+    uint64_t hits, misses;
+    llmq::CLLMQUtils::GetQuorumMembersCacheStats(hits, misses);
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("hits", hits));
+    ret.push_back(Pair("misses", misses));
+    return ret;
+}
+
+void quorum_sigsharestats_help()
+{
+    throw std::runtime_error(
+            "quorum sigsharestats\n"
+            "Return latency histograms of the stages incoming signature shares go through.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"receiveToVerify\": {        (json object) From receiving a share until it is verified\n"
+            "    \"count\": n,               (numeric) Number of samples\n"
+            "    \"avgMs\": n,               (numeric) Average latency in milliseconds\n"
+            "    \"maxMs\": n,               (numeric) Maximum latency in milliseconds\n"
+            "    \"buckets\": {              (json object) Number of samples per latency bucket\n"
+            "      \"<1ms\": n,\n"
+            "      ...\n"
+            "      \">=10000ms\": n\n"
+            "    }\n"
+            "  },\n"
+            "  \"verifyToRecover\": {...},   (json object) From the share completing the threshold until recovery\n"
+            "  \"firstShareToRecover\": {...} (json object) From the first share of a session until recovery\n"
+            "}\n"
+    );
+}
+
+static UniValue LatencyHistogramToJSON(const CLatencyHistogram& histogram)
+{
+    UniValue buckets(UniValue::VOBJ);
+    for (size_t i = 0; i < CLatencyHistogram::BUCKET_COUNT; i++) {
+        int64_t limit = CLatencyHistogram::GetBucketLimit(i);
+        std::string name = limit != -1 ? strprintf("<%dms", limit) : strprintf(">=%dms", CLatencyHistogram::GetBucketLimit(i - 1));
+        buckets.push_back(Pair(name, histogram.GetBucketCount(i)));
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("count", histogram.GetCount()));
+    ret.push_back(Pair("avgMs", histogram.GetAverageMicros() / 1000.0));
+    ret.push_back(Pair("maxMs", histogram.GetMaxMicros() / 1000.0));
+    ret.push_back(Pair("buckets", buckets));
+    return ret;
+}
+
+UniValue quorum_sigsharestats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1) {
+        quorum_sigsharestats_help();
+    }
+
+    const auto& stats = llmq::quorumSigSharesManager->GetLatencyStats();
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("receiveToVerify", LatencyHistogramToJSON(stats.receiveToVerify)));
+    ret.push_back(Pair("verifyToRecover", LatencyHistogramToJSON(stats.verifyToRecover)));
+    ret.push_back(Pair("firstShareToRecover", LatencyHistogramToJSON(stats.firstShareToRecover)));
+    return ret;
+}
+
+void quorum_chainlockstats_help()
+{
+    throw std::runtime_error(
+            "quorum chainlockstats\n"
+            "Return the time it took from blocks becoming the chain tip until they got ChainLocked.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"tipToChainLock\": {...},   (json object) Latency histogram, same format as in \"quorum sigsharestats\"\n"
+            "  \"recent\": [                (array) The most recently ChainLocked blocks, oldest first\n"
+            "    {\n"
+            "      \"height\": n,            (numeric) Block height\n"
+            "      \"blockhash\": \"hash\",   (string) Block hash\n"
+            "      \"ms\": n                 (numeric) Time from becoming the chain tip until the ChainLock in milliseconds\n"
+            "    }, ...\n"
+            "  ]\n"
+            "}\n"
+    );
+}
+
+UniValue quorum_chainlockstats(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 1) {
+        quorum_chainlockstats_help();
+    }
+
+    UniValue recent(UniValue::VARR);
+    for (const auto& e : llmq::chainLocksHandler->GetRecentChainLockLatencies()) {
+        UniValue obj(UniValue::VOBJ);
+        obj.push_back(Pair("height", e.nHeight));
+        obj.push_back(Pair("blockhash", e.blockHash.ToString()));
+        obj.push_back(Pair("ms", e.micros / 1000.0));
+        recent.push_back(obj);
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("tipToChainLock", LatencyHistogramToJSON(llmq::chainLocksHandler->GetTipToChainLockStats())));
+    ret.push_back(Pair("recent", recent));
+    return ret;
+}
+
 void quorum_memberof_help()
 {
     throw std::runtime_error(
@@ -387,6 +513,9 @@ UniValue quorum_dkgsimerror(const JSONRPCRequest& request)
             "  dkgsimerror       - Simulates DKG errors and malicious behavior.\n"
             "  dkgstatus         - Return the status of the current DKG process\n"
             "  memberof          - Checks which quorums the given masternode is a member of\n"
+            "  memberscache      - Return hit and miss counters of the quorum members cache\n"
+            "  sigsharestats     - Return latency histograms of signature share processing\n"
+            "  chainlockstats    - Return the time it took until recent blocks got ChainLocked\n"
             "  sign              - Threshold-sign a message\n"
             "  hasrecsig         - Test if a valid recovered signature is present\n"
             "  getrecsig         - Get a recovered signature\n"
@@ -413,6 +542,12 @@ UniValue quorum(const JSONRPCRequest& request)
         return quorum_dkgstatus(request);
     } else if (command == "memberof") {
         return quorum_memberof(request);
+    } else if (command == "memberscache") {
+        return quorum_memberscache(request);
+    } else if (command == "sigsharestats") {
+        return quorum_sigsharestats(request);
+    } else if (command == "chainlockstats") {
+        return quorum_chainlockstats(request);
     } else if (command == "sign" || command == "hasrecsig" || command == "getrecsig" || command == "isconflicting") {
         return quorum_sigs_cmd(request);
     } else if (command == "dkgsimerror") {
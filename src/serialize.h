@@ -361,10 +361,10 @@ I ReadVarInt(Stream& is)
 }
 
 #define FLATDATA(obj) REF(CFlatData((char*)&(obj), (char*)&(obj) + sizeof(obj)))
-#define FIXEDBITSET(obj, size) REF(CFixedBitSet(REF(obj), (size)))
-#define DYNBITSET(obj) REF(CDynamicBitSet(REF(obj)))
-#define FIXEDVARINTSBITSET(obj, size) REF(CFixedVarIntsBitSet(REF(obj), (size)))
-#define AUTOBITSET(obj, size) REF(CAutoBitSet(REF(obj), (size)))
+#define FIXEDBITSET(obj, size) REF(MakeFixedBitSet(REF(obj), (size)))
+#define DYNBITSET(obj) REF(MakeDynamicBitSet(REF(obj)))
+#define FIXEDVARINTSBITSET(obj, size) REF(MakeFixedVarIntsBitSet(REF(obj), (size)))
+#define AUTOBITSET(obj, size) REF(MakeAutoBitSet(REF(obj), (size)))
 #define VARINT(obj) REF(WrapVarInt(REF(obj)))
 #define COMPACTSIZE(obj) REF(CCompactSize(REF(obj)))
 #define LIMITED_STRING(obj,n) REF(LimitedString< n >(REF(obj)))
@@ -409,64 +409,83 @@ public:
     }
 };
 
+/**
+ * The bitset wrappers below work with std::vector<bool> and any other bitset type which offers size(), resize(),
+ * assign() and operator[]. Types which can do better than bit by bit (de)serialization can provide overloads of
+ * SerializeFixedBitSet/UnserializeFixedBitSet.
+ */
+template<typename Stream, typename BitSet>
+void SerializeFixedBitSet(Stream& s, const BitSet& vec, size_t size)
+{
+    std::vector<unsigned char> vBytes((size + 7) / 8);
+    size_t ms = std::min(size, (size_t)vec.size());
+    for (size_t p = 0; p < ms; p++)
+        vBytes[p / 8] |= vec[p] << (p % 8);
+    s.write((char*)vBytes.data(), vBytes.size());
+}
+
+template<typename Stream, typename BitSet>
+void UnserializeFixedBitSet(Stream& s, BitSet& vec, size_t size)
+{
+    vec.resize(size);
+
+    std::vector<unsigned char> vBytes((size + 7) / 8);
+    s.read((char*)vBytes.data(), vBytes.size());
+    for (size_t p = 0; p < size; p++)
+        vec[p] = (vBytes[p / 8] & (1 << (p % 8))) != 0;
+    if (vBytes.size() * 8 != size) {
+        size_t rem = vBytes.size() * 8 - size;
+        uint8_t m = ~(uint8_t)(0xff >> rem);
+        if (vBytes[vBytes.size() - 1] & m) {
+            throw std::ios_base::failure("Out-of-range bits set");
+        }
+    }
+}
+
+template<typename BitSet>
 class CFixedBitSet
 {
 protected:
-    std::vector<bool>& vec;
+    BitSet& vec;
     size_t size;
 
 public:
-    CFixedBitSet(std::vector<bool>& vecIn, size_t sizeIn) : vec(vecIn), size(sizeIn) {}
+    CFixedBitSet(BitSet& vecIn, size_t sizeIn) : vec(vecIn), size(sizeIn) {}
 
     template<typename Stream>
     void Serialize(Stream& s) const
     {
-        std::vector<unsigned char> vBytes((size + 7) / 8);
-        size_t ms = std::min(size, vec.size());
-        for (size_t p = 0; p < ms; p++)
-            vBytes[p / 8] |= vec[p] << (p % 8);
-        s.write((char*)vBytes.data(), vBytes.size());
+        SerializeFixedBitSet(s, vec, size);
     }
 
     template<typename Stream>
     void Unserialize(Stream& s)
     {
-        vec.resize(size);
-
-        std::vector<unsigned char> vBytes((size + 7) / 8);
-        s.read((char*)vBytes.data(), vBytes.size());
-        for (size_t p = 0; p < size; p++)
-            vec[p] = (vBytes[p / 8] & (1 << (p % 8))) != 0;
-        if (vBytes.size() * 8 != size) {
-            size_t rem = vBytes.size() * 8 - size;
-            uint8_t m = ~(uint8_t)(0xff >> rem);
-            if (vBytes[vBytes.size() - 1] & m) {
-                throw std::ios_base::failure("Out-of-range bits set");
-            }
-        }
+        UnserializeFixedBitSet(s, vec, size);
     }
 };
 
+template<typename BitSet>
 class CDynamicBitSet
 {
 protected:
-    std::vector<bool>& vec;
+    BitSet& vec;
 
 public:
-    explicit CDynamicBitSet(std::vector<bool>& vecIn) : vec(vecIn) {}
+    explicit CDynamicBitSet(BitSet& vecIn) : vec(vecIn) {}
 
     template<typename Stream>
     void Serialize(Stream& s) const
     {
         WriteCompactSize(s, vec.size());
-        CFixedBitSet(REF(vec), vec.size()).Serialize(s);
+        SerializeFixedBitSet(s, vec, vec.size());
     }
 
     template<typename Stream>
     void Unserialize(Stream& s)
     {
-        vec.resize(ReadCompactSize(s));
-        CFixedBitSet(vec, vec.size()).Unserialize(s);
+        size_t size = ReadCompactSize(s);
+        UnserializeFixedBitSet(s, vec, size);
     }
 };
 
@@ -474,14 +493,15 @@ public:
  * Stores a fixed size bitset as a series of VarInts. Each VarInt is an offset from the last entry and the sum of the
  * last entry and the offset gives an index into the bitset for a set bit. The series of VarInts ends with a 0.
  */
+template<typename BitSet>
 class CFixedVarIntsBitSet
 {
 protected:
-    std::vector<bool>& vec;
+    BitSet& vec;
     size_t size;
 
 public:
-    CFixedVarIntsBitSet(std::vector<bool>& vecIn, size_t sizeIn) : vec(vecIn), size(sizeIn) {}
+    CFixedVarIntsBitSet(BitSet& vecIn, size_t sizeIn) : vec(vecIn), size(sizeIn) {}
 
     template<typename Stream>
     void Serialize(Stream& s) const
@@ -523,29 +543,30 @@ public:
 /**
  * Serializes either as a CFixedBitSet or CFixedVarIntsBitSet, depending on which would give a smaller size
  */
+template<typename BitSet>
 class CAutoBitSet
 {
 protected:
-    std::vector<bool>& vec;
+    BitSet& vec;
     size_t size;
 
 public:
-    explicit CAutoBitSet(std::vector<bool>& vecIn, size_t sizeIn) : vec(vecIn), size(sizeIn) {}
+    explicit CAutoBitSet(BitSet& vecIn, size_t sizeIn) : vec(vecIn), size(sizeIn) {}
 
     template<typename Stream>
     void Serialize(Stream& s) const
     {
         assert(vec.size() == size);
 
-        size_t size1 = ::GetSerializeSize(s, CFixedBitSet(vec, size));
-        size_t size2 = ::GetSerializeSize(s, CFixedVarIntsBitSet(vec, size));
+        size_t size1 = ::GetSerializeSize(s, CFixedBitSet<BitSet>(vec, size));
+        size_t size2 = ::GetSerializeSize(s, CFixedVarIntsBitSet<BitSet>(vec, size));
 
         if (size1 < size2) {
             ser_writedata8(s, 0);
-            s << FIXEDBITSET(vec, vec.size());
+            s << CFixedBitSet<BitSet>(vec, vec.size());
         } else {
             ser_writedata8(s, 1);
-            s << FIXEDVARINTSBITSET(vec, vec.size());
+            s << CFixedVarIntsBitSet<BitSet>(vec, vec.size());
         }
     }
 
@@ -558,13 +579,22 @@ public:
         }
 
         if (!isVarInts) {
-            s >> FIXEDBITSET(vec, size);
+            s >> REF(CFixedBitSet<BitSet>(vec, size));
         } else {
-            s >> FIXEDVARINTSBITSET(vec, size);
+            s >> REF(CFixedVarIntsBitSet<BitSet>(vec, size));
         }
     }
 };
 
+template<typename BitSet>
+CFixedBitSet<BitSet> MakeFixedBitSet(BitSet& vec, size_t size) { return CFixedBitSet<BitSet>(vec, size); }
+template<typename BitSet>
+CDynamicBitSet<BitSet> MakeDynamicBitSet(BitSet& vec) { return CDynamicBitSet<BitSet>(vec); }
+template<typename BitSet>
+CFixedVarIntsBitSet<BitSet> MakeFixedVarIntsBitSet(BitSet& vec, size_t size) { return CFixedVarIntsBitSet<BitSet>(vec, size); }
+template<typename BitSet>
+CAutoBitSet<BitSet> MakeAutoBitSet(BitSet& vec, size_t size) { return CAutoBitSet<BitSet>(vec, size); }
+
 template<typename I>
 class CVarInt
 {
@@ -77,9 +77,9 @@ static void AddMessage(std::vector<Message>& vec, uint32_t sourceId, uint32_t ms
     vec.emplace_back(m);
 }
 
-static void Verify(std::vector<Message>& vec, bool secureVerification, bool perMessageFallback)
+static void Verify(std::vector<Message>& vec, bool secureVerification, bool perMessageFallback, CBLSWorker* worker)
 {
-    CBLSBatchVerifier<uint32_t, uint32_t> batchVerifier(secureVerification, perMessageFallback);
+    CBLSBatchVerifier<uint32_t, uint32_t> batchVerifier(secureVerification, perMessageFallback, 0, worker);
 
     std::set<uint32_t> expectedBadMessages;
     std::set<uint32_t> expectedBadSources;
@@ -105,10 +105,16 @@ static void Verify(std::vector<Message>& vec, bool secureVerification, bool perM
 
 static void Verify(std::vector<Message>& vec)
 {
-    Verify(vec, false, false);
-    Verify(vec, true, false);
-    Verify(vec, false, true);
-    Verify(vec, true, true);
+    // the same results are expected when sources are verified in parallel
+    CBLSWorker worker;
+    worker.Start();
+    for (CBLSWorker* w : {(CBLSWorker*)nullptr, &worker}) {
+        Verify(vec, false, false, w);
+        Verify(vec, true, false, w);
+        Verify(vec, false, true, w);
+        Verify(vec, true, true, w);
+    }
+    worker.Stop();
 }
 
 BOOST_AUTO_TEST_CASE(batch_verifier_tests)
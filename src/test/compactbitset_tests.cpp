@@ -0,0 +1,108 @@
+// Copyright (c) 2020 The BeeGroup developers are EternityGroup
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "compactbitset.h"
+#include "streams.h"
+#include "test/test_beenode.h"
+#include "test/test_random.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(compactbitset_tests, BasicTestingSetup)
+
+static void RandomBitSets(size_t size, int percentSet, std::vector<bool>& vecRet, CCompactBitSet& bitSetRet)
+{
+    vecRet.assign(size, false);
+    bitSetRet.assign(size, false);
+    for (size_t i = 0; i < size; i++) {
+        bool v = (int)(insecure_rand() % 100) < percentSet;
+        vecRet[i] = v;
+        bitSetRet[i] = v;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compactbitset_basics)
+{
+    CCompactBitSet b(130);
+    BOOST_CHECK_EQUAL(b.size(), 130);
+    BOOST_CHECK_EQUAL(b.count(), 0);
+    BOOST_CHECK(!b.any());
+
+    b[0] = true;
+    b.set(64);
+    b[129] = true;
+    BOOST_CHECK_EQUAL(b.count(), 3);
+    BOOST_CHECK(b.any());
+    BOOST_CHECK(b[64] && !b[65]);
+
+    // shrinking must clear the removed bits
+    b.resize(100);
+    BOOST_CHECK_EQUAL(b.count(), 2);
+    b.resize(130);
+    BOOST_CHECK(!b[129]);
+
+    b.SetAll(true);
+    BOOST_CHECK_EQUAL(b.count(), 130);
+    b.assign(70, false);
+    BOOST_CHECK_EQUAL(b.count(), 0);
+
+    BOOST_CHECK_THROW(b.resize(CCompactBitSet::MAX_SIZE + 1), std::length_error);
+}
+
+BOOST_AUTO_TEST_CASE(compactbitset_merge)
+{
+    for (size_t size : {1, 63, 64, 65, 400, 512}) {
+        std::vector<bool> v1, v2;
+        CCompactBitSet b1, b2;
+        RandomBitSets(size, 30, v1, b1);
+        RandomBitSets(size, 30, v2, b2);
+
+        CCompactBitSet bOr = b1, bAnd = b1;
+        bOr |= b2;
+        bAnd &= b2;
+        for (size_t i = 0; i < size; i++) {
+            BOOST_CHECK_EQUAL(bOr[i], v1[i] || v2[i]);
+            BOOST_CHECK_EQUAL(bAnd[i], v1[i] && v2[i]);
+        }
+        BOOST_CHECK_EQUAL(b1.count(), (size_t)std::count(v1.begin(), v1.end(), true));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(compactbitset_serialization)
+{
+    for (size_t size : {0, 1, 7, 8, 9, 63, 64, 65, 400, 512}) {
+        for (int percentSet : {0, 5, 50, 100}) {
+            std::vector<bool> v;
+            CCompactBitSet b;
+            RandomBitSets(size, percentSet, v, b);
+
+            // must be byte-identical to the std::vector<bool> serialization
+            CDataStream dsVec(SER_NETWORK, PROTOCOL_VERSION);
+            CDataStream dsBitSet(SER_NETWORK, PROTOCOL_VERSION);
+            dsVec << DYNBITSET(v) << AUTOBITSET(v, size);
+            dsBitSet << DYNBITSET(b) << AUTOBITSET(b, size);
+            BOOST_CHECK(dsVec.str() == dsBitSet.str());
+
+            CCompactBitSet b2, b3;
+            dsBitSet >> DYNBITSET(b2) >> AUTOBITSET(b3, size);
+            BOOST_CHECK(b2 == b);
+            BOOST_CHECK(b3 == b);
+        }
+    }
+
+    // out-of-range bits in the last byte
+    CDataStream ds(SER_NETWORK, PROTOCOL_VERSION);
+    WriteCompactSize(ds, 4);
+    ser_writedata8(ds, 0x10);
+    CCompactBitSet b;
+    BOOST_CHECK_THROW(ds >> DYNBITSET(b), std::ios_base::failure);
+
+    // larger than supported
+    std::vector<bool> v(CCompactBitSet::MAX_SIZE + 1, true);
+    ds.clear();
+    ds << DYNBITSET(v);
+    BOOST_CHECK_THROW(ds >> DYNBITSET(b), std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -255,6 +255,75 @@ BOOST_AUTO_TEST_CASE(sha256_testvectors) {
     TestSHA256(test1, "a316d55510b49662420f49d145d42fb83f31ef8dc016aa4e32df049991a91e26");
 }
 
+BOOST_AUTO_TEST_CASE(sha256d64)
+{
+    for (int i = 0; i <= 34; ++i) {
+        unsigned char in[64 * 34];
+        unsigned char out1[32 * 34], out2[32 * 34];
+        for (int j = 0; j < 64 * i; ++j) {
+            in[j] = insecure_rand();
+        }
+        for (int j = 0; j < i; ++j) {
+            unsigned char tmp[32];
+            CSHA256().Write(in + 64 * j, 64).Finalize(tmp);
+            CSHA256().Write(tmp, 32).Finalize(out1 + 32 * j);
+        }
+        SHA256D64(out2, in, i);
+        BOOST_CHECK(memcmp(out1, out2, 32 * i) == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sha256s64)
+{
+    for (int i = 0; i <= 34; ++i) {
+        unsigned char in[64 * 34];
+        unsigned char out1[32 * 34], out2[32 * 34];
+        for (int j = 0; j < 64 * i; ++j) {
+            in[j] = insecure_rand();
+        }
+        for (int j = 0; j < i; ++j) {
+            CSHA256().Write(in + 64 * j, 64).Finalize(out1 + 32 * j);
+        }
+        SHA256S64(out2, in, i);
+        BOOST_CHECK(memcmp(out1, out2, 32 * i) == 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sha256_backends)
+{
+    // Every backend available on this CPU has to agree with the standard implementation.
+    using namespace sha256_implementation;
+    const std::vector<UseImplementation> implementations = {STANDARD, USE_SSE4, USE_AVX2, USE_SHANI, USE_ALL};
+    for (UseImplementation use_implementation : implementations) {
+        BOOST_TEST_MESSAGE("SHA256 implementation: " << SHA256AutoDetect(use_implementation));
+        TestSHA256("abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+        TestSHA256("This is exactly 64 bytes long, not counting the terminating byte",
+                   "ab64eff7e88e2e46165e29f2bce41826bd4c7b3552f6b382a9e7d3af47c245f8");
+        TestSHA256(std::string(1000000, 'a'),
+                   "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+
+        unsigned char in[64 * 19];
+        unsigned char out1[32 * 19], out2[32 * 19];
+        for (size_t j = 0; j < sizeof(in); ++j) {
+            in[j] = insecure_rand();
+        }
+        for (int j = 0; j < 19; ++j) {
+            unsigned char tmp[32];
+            CSHA256().Write(in + 64 * j, 64).Finalize(tmp);
+            CSHA256().Write(tmp, 32).Finalize(out1 + 32 * j);
+        }
+        SHA256D64(out2, in, 19);
+        BOOST_CHECK(memcmp(out1, out2, sizeof(out1)) == 0);
+
+        for (int j = 0; j < 19; ++j) {
+            CSHA256().Write(in + 64 * j, 64).Finalize(out1 + 32 * j);
+        }
+        SHA256S64(out2, in, 19);
+        BOOST_CHECK(memcmp(out1, out2, sizeof(out1)) == 0);
+    }
+    SHA256AutoDetect();
+}
+
 BOOST_AUTO_TEST_CASE(sha512_testvectors) {
     TestSHA512("",
                "cf83e1357eefb8bdf1542850d66d8007d620e4050b5715dc83f4a921d36ce9ce"
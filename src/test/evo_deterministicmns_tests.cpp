@@ -18,6 +18,9 @@
 #include "evo/providertx.h"
 #include "evo/deterministicmns.h"
 
+#include "bls/bls_worker.h"
+#include "llmq/quorums_init.h"
+
 #include <boost/test/unit_test.hpp>
 
 static const CBitcoinAddress payoutAddress  ("yRq1Ky1AfFmf597rnotj7QRxsDUKePVWNF");
@@ -401,4 +404,194 @@ BOOST_FIXTURE_TEST_CASE(dip3_protx, TestChainDIP3Setup)
 
     const_cast<Consensus::Params&>(Params().GetConsensus()).DIP0003EnforcementHeight = DIP0003EnforcementHeightBackup;
 }
+
+BOOST_FIXTURE_TEST_CASE(mnlist_cache_replay, TestChainDIP3Setup)
+{
+    auto utxos = BuildSimpleUtxoMap(coinbaseTxns);
+
+    // register one MN per block, with some empty blocks in-between
+    for (size_t i = 0; i < 12; i++) {
+        std::vector<CMutableTransaction> txns;
+        if (i % 3 != 2) {
+            CKey ownerKey;
+            CBLSSecretKey operatorKey;
+            txns.emplace_back(CreateProRegTx(utxos, (int)i + 1, GenerateRandomAddress(), coinbaseKey, ownerKey, operatorKey));
+        }
+        CreateAndProcessBlock(txns, coinbaseKey);
+        deterministicMNManager->UpdatedBlockTip(chainActive.Tip());
+    }
+
+    // a second manager without any cached lists must replay the same lists from the stored snapshots and diffs,
+    // even when it can't keep more than a single list in its cache
+    CDeterministicMNManager replayManager(*evoDb, DEFAULT_MNLIST_SNAPSHOT_PERIOD, 1);
+    for (int nHeight = chainActive.Height(); nHeight >= 0; nHeight--) {
+        auto expected = deterministicMNManager->GetListForBlock(chainActive[nHeight]);
+        auto replayed = replayManager.GetListForBlock(chainActive[nHeight]);
+        BOOST_CHECK_EQUAL(replayed.GetHeight(), expected.GetHeight());
+        BOOST_CHECK_EQUAL(replayed.GetBlockHash().ToString(), expected.GetBlockHash().ToString());
+        BOOST_CHECK_EQUAL(SerializeHash(replayed).ToString(), SerializeHash(expected).ToString());
+    }
+
+    auto stats = replayManager.GetCacheStats();
+    BOOST_CHECK_EQUAL(stats.nEntries, 1U);
+    BOOST_CHECK_EQUAL(stats.nHits, 0U);
+    BOOST_CHECK(stats.nMaxReplayDepth > 0);
+
+    // with a big enough cache, the second lookup of a list is a hit
+    CDeterministicMNManager cachingManager(*evoDb);
+    cachingManager.GetListForBlock(chainActive.Tip());
+    cachingManager.GetListForBlock(chainActive.Tip());
+    cachingManager.GetListForBlock(chainActive.Tip()->pprev);
+    stats = cachingManager.GetCacheStats();
+    BOOST_CHECK_EQUAL(stats.nHits, 2U);
+    BOOST_CHECK_EQUAL(stats.nMisses, 1U);
+    BOOST_CHECK(stats.nMemoryUsage > 0 && stats.nMemoryUsage <= stats.nMaxMemoryUsage);
+}
+
+BOOST_FIXTURE_TEST_CASE(calculate_quorum, BasicTestingSetup)
+{
+    CDeterministicMNList mnList(uint256(), 0, 0);
+    for (int i = 0; i < 500; i++) {
+        auto dmn = std::make_shared<CDeterministicMN>();
+        dmn->proTxHash = GetRandHash();
+        dmn->internalId = i;
+        dmn->collateralOutpoint = COutPoint(GetRandHash(), 0);
+        auto dmnState = std::make_shared<CDeterministicMNState>();
+        uint256 ownerHash = GetRandHash();
+        dmnState->keyIDOwner = CKeyID(uint160(std::vector<unsigned char>(ownerHash.begin(), ownerHash.begin() + 20)));
+        if (i % 10 != 0) {
+            // leave some MNs unconfirmed, they must not be part of any quorum
+            dmnState->UpdateConfirmedHash(dmn->proTxHash, GetRandHash());
+        }
+        dmn->pdmnState = dmnState;
+        mnList.AddMN(dmn);
+    }
+
+    // reference: fully sorted scores in descending order
+    uint256 modifier = GetRandHash();
+    auto scores = mnList.CalculateScores(modifier);
+    BOOST_CHECK_EQUAL(scores.size(), 450U);
+    for (const auto& p : scores) {
+        // the batched scores must match the plain single-sha256 of each MN
+        uint256 h;
+        CSHA256()
+            .Write(p.second->pdmnState->confirmedHashWithProRegTxHash.begin(), 32)
+            .Write(modifier.begin(), 32)
+            .Finalize(h.begin());
+        BOOST_CHECK(p.first == UintToArith256(h));
+    }
+    std::sort(scores.rbegin(), scores.rend(), [](const std::pair<arith_uint256, CDeterministicMNCPtr>& a, const std::pair<arith_uint256, CDeterministicMNCPtr>& b) {
+        if (a.first == b.first) {
+            return a.second->collateralOutpoint < b.second->collateralOutpoint;
+        }
+        return a.first < b.first;
+    });
+
+    for (size_t size : {0, 1, 50, 449, 450, 1000}) {
+        auto quorum = mnList.CalculateQuorum(size, modifier);
+        BOOST_CHECK_EQUAL(quorum.size(), std::min(size, scores.size()));
+        for (size_t i = 0; i < quorum.size(); i++) {
+            BOOST_CHECK(quorum[i] == scores[i].second);
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(calculate_scores_parallel, BasicTestingSetup)
+{
+    CDeterministicMNList mnList(uint256(), 0, 0);
+    for (int i = 0; i < 5000; i++) {
+        auto dmn = std::make_shared<CDeterministicMN>();
+        dmn->proTxHash = GetRandHash();
+        dmn->internalId = i;
+        dmn->collateralOutpoint = COutPoint(GetRandHash(), 0);
+        auto dmnState = std::make_shared<CDeterministicMNState>();
+        uint256 ownerHash = GetRandHash();
+        dmnState->keyIDOwner = CKeyID(uint160(std::vector<unsigned char>(ownerHash.begin(), ownerHash.begin() + 20)));
+        dmnState->UpdateConfirmedHash(dmn->proTxHash, GetRandHash());
+        dmn->pdmnState = dmnState;
+        mnList.AddMN(dmn);
+    }
+
+    uint256 modifier = GetRandHash();
+    auto serialScores = mnList.CalculateScores(modifier);
+
+    // splitting the work across the BLS worker threads must not change the results or their order
+    CBLSWorker* blsWorkerBackup = llmq::blsWorker;
+    CBLSWorker worker;
+    worker.Start();
+    llmq::blsWorker = &worker;
+    auto parallelScores = mnList.CalculateScores(modifier);
+    llmq::blsWorker = blsWorkerBackup;
+    worker.Stop();
+
+    BOOST_CHECK_EQUAL(parallelScores.size(), 5000U);
+    BOOST_CHECK(parallelScores == serialScores);
+}
+
+BOOST_FIXTURE_TEST_CASE(mnlist_secondary_indexes, BasicTestingSetup)
+{
+    CDeterministicMNList mnList(uint256(), 0, 0);
+    std::vector<CBLSSecretKey> operatorKeys(10);
+    CScript sharedPayout = GenerateRandomAddress();
+    CKey votingKey;
+    votingKey.MakeNewKey(false);
+    CKeyID sharedVotingKey = votingKey.GetPubKey().GetID();
+    for (int i = 0; i < 10; i++) {
+        operatorKeys[i].MakeNewKey();
+
+        auto dmn = std::make_shared<CDeterministicMN>();
+        dmn->proTxHash = GetRandHash();
+        dmn->internalId = i;
+        dmn->collateralOutpoint = COutPoint(GetRandHash(), 0);
+        auto dmnState = std::make_shared<CDeterministicMNState>();
+        uint256 ownerHash = GetRandHash();
+        dmnState->keyIDOwner = CKeyID(uint160(std::vector<unsigned char>(ownerHash.begin(), ownerHash.begin() + 20)));
+        dmnState->pubKeyOperator.Set(operatorKeys[i].GetPublicKey());
+        // every second MN shares its payee and voting key
+        if (i % 2 == 0) {
+            dmnState->scriptPayout = sharedPayout;
+            uint256 votingHash = GetRandHash();
+            dmnState->keyIDVoting = CKeyID(uint160(std::vector<unsigned char>(votingHash.begin(), votingHash.begin() + 20)));
+        } else {
+            dmnState->scriptPayout = GenerateRandomAddress();
+            dmnState->keyIDVoting = sharedVotingKey;
+        }
+        dmn->pdmnState = dmnState;
+        mnList.AddMN(dmn);
+    }
+
+    std::vector<CDeterministicMNCPtr> mns;
+    mnList.ForEachMN(false, [&](const CDeterministicMNCPtr& dmn) { mns.emplace_back(dmn); });
+    for (const auto& dmn : mns) {
+        BOOST_CHECK(mnList.GetMNByOperatorKey(dmn->pdmnState->pubKeyOperator.Get()) == dmn);
+        auto byPayee = mnList.GetMNsByPayoutScript(dmn->pdmnState->scriptPayout);
+        BOOST_CHECK_EQUAL(byPayee.size(), dmn->pdmnState->scriptPayout == sharedPayout ? 5U : 1U);
+        BOOST_CHECK(std::count(byPayee.begin(), byPayee.end(), dmn) == 1);
+        auto byVotingKey = mnList.GetMNsByVotingKey(dmn->pdmnState->keyIDVoting);
+        BOOST_CHECK_EQUAL(byVotingKey.size(), dmn->pdmnState->keyIDVoting == sharedVotingKey ? 5U : 1U);
+        BOOST_CHECK(std::count(byVotingKey.begin(), byVotingKey.end(), dmn) == 1);
+    }
+    BOOST_CHECK(mnList.GetMNsByPayoutScript(GenerateRandomAddress()).empty());
+
+    // moving an MN to another payee and voting key updates both indexes
+    auto newState = std::make_shared<CDeterministicMNState>(*mns[0]->pdmnState);
+    CScript newPayout = GenerateRandomAddress();
+    newState->scriptPayout = newPayout;
+    newState->keyIDVoting = sharedVotingKey;
+    bool wasSharedPayout = mns[0]->pdmnState->scriptPayout == sharedPayout;
+    mnList.UpdateMN(mns[0]->proTxHash, newState);
+    BOOST_CHECK_EQUAL(mnList.GetMNsByPayoutScript(sharedPayout).size(), wasSharedPayout ? 4U : 5U);
+    BOOST_CHECK_EQUAL(mnList.GetMNsByPayoutScript(newPayout).size(), 1U);
+    BOOST_CHECK(mnList.GetMNsByPayoutScript(newPayout)[0]->pdmnState == newState);
+
+    // removed MNs disappear from all indexes
+    for (const auto& dmn : mns) {
+        mnList.RemoveMN(dmn->proTxHash);
+        BOOST_CHECK(mnList.GetMNByOperatorKey(dmn->pdmnState->pubKeyOperator.Get()) == nullptr);
+    }
+    BOOST_CHECK(mnList.GetMNsByPayoutScript(sharedPayout).empty());
+    BOOST_CHECK(mnList.GetMNsByPayoutScript(newPayout).empty());
+    BOOST_CHECK(mnList.GetMNsByVotingKey(sharedVotingKey).empty());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
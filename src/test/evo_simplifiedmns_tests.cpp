@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "test/test_beenode.h"
+#include "test/test_random.h"
 
 #include "bls/bls.h"
 #include "evo/simplifiedmns.h"
@@ -70,4 +71,68 @@ BOOST_AUTO_TEST_CASE(simplifiedmns_merkleroots)
 
     BOOST_CHECK(expectedMerkleRoot == calculatedMerkleRoot);
 }
+
+BOOST_AUTO_TEST_CASE(simplifiedmns_incremental_merkleroots)
+{
+    std::vector<CSimplifiedMNListEntry> entries;
+    CSimplifiedMNListMerkleTree tree;
+
+    auto checkRoot = [&](size_t nExpectedRehashed) {
+        CSimplifiedMNList sml(entries);
+        bool mutated1, mutated2;
+        BOOST_CHECK_EQUAL(tree.Update(sml), nExpectedRehashed);
+        BOOST_CHECK_EQUAL(tree.GetRoot(&mutated1).ToString(), sml.CalcMerkleRoot(&mutated2).ToString());
+        BOOST_CHECK_EQUAL(mutated1, mutated2);
+    };
+    auto newEntry = [&]() {
+        CSimplifiedMNListEntry smle;
+        smle.proRegTxHash = GetRandHash();
+        smle.confirmedHash = GetRandHash();
+        smle.isValid = true;
+        return smle;
+    };
+
+    checkRoot(0);
+    for (size_t i = 0; i < 100; i++) {
+        entries.emplace_back(newEntry());
+        if (i < 5 || i == 31 || i == 32 || i == 99) {
+            checkRoot(entries.size());
+            tree = CSimplifiedMNListMerkleTree();
+        }
+    }
+
+    checkRoot(100);
+    checkRoot(0);
+
+    // change single entries in various positions
+    for (size_t i : {0, 1, 50, 98, 99}) {
+        entries[i].isValid = !entries[i].isValid;
+        checkRoot(1);
+    }
+    for (size_t i = 0; i < 10; i++) {
+        entries[i * 10 + insecure_rand() % 10].confirmedHash = GetRandHash();
+    }
+    checkRoot(10);
+
+    // add and remove entries, which changes the tree structure
+    for (size_t i = 0; i < 10; i++) {
+        entries.emplace_back(newEntry());
+        checkRoot(1);
+    }
+    while (entries.size() > 1) {
+        entries.erase(entries.begin() + insecure_rand() % entries.size());
+        checkRoot(0);
+    }
+    entries.clear();
+    checkRoot(0);
+
+    // duplicate entries result in a mutated tree
+    for (size_t i = 0; i < 7; i++) {
+        entries.emplace_back(newEntry());
+    }
+    entries.emplace_back(entries[3]);
+    checkRoot(8);
+    entries.pop_back();
+    checkRoot(0);
+}
 BOOST_AUTO_TEST_SUITE_END()
@@ -3,8 +3,10 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "hash.h"
+#include "primitives/block.h"
 #include "utilstrencodings.h"
 #include "test/test_beenode.h"
+#include "test/test_random.h"
 
 #include <vector>
 
@@ -149,4 +151,76 @@ BOOST_AUTO_TEST_CASE(siphash)
     BOOST_CHECK_EQUAL(SipHashUint256(1, 2, ss.GetHash()), 0x79751e980c2a0a35ULL);
 }
 
+BOOST_AUTO_TEST_CASE(honeycomb)
+{
+    // Expected values were produced by the byte-wise HashHoneyComb this hasher replaced,
+    // over the zero-filled inputs used by bench/crypto_hash.cpp.
+    static const struct {
+        size_t size;
+        const char* hash;
+    } vectors[] = {
+        {36, "9dfe23834fe7a331766b642954a1ebbac77b9060f02e0440845854a59ae72917"},
+        {64, "45f94a9ba0c0bb87226d26034c2cb824b0ea5f972b95f8805f3aa3fa4cd5ff7b"},
+        {80, "956943a7985d5d2df8ae05cea4f859fefbfa5f1da2414eb9b9b1a66d4ba4a0d1"},
+        {128, "bb5d89c7b6a563dccca5997685d708332b31fa621cee306066ff770efc52e743"},
+        {512, "b654231621cd2d5dfb58d6c6271c8093b5dd55dc34acea7f5a13b5bf105dd94d"},
+        {1024, "880f3c0468b38e902e81e1820081edcdd875d6f123255d169e129a65c4b0d95f"},
+        {2048, "7a937a90ccf78acfd2a6f8385bd677d03e062d2261b3c6156b21ca86db870473"},
+        {1000000, "ac63ecac99bda7f3e0f7acd0ebbb117fd162a907895fc82956d84e86a1dce7bb"},
+    };
+
+    CHoneyCombHasher reused;
+    for (const auto& v : vectors) {
+        std::vector<unsigned char> in(v.size, 0);
+        BOOST_CHECK_EQUAL(HashHoneyComb(in.begin(), in.end()).ToString(), v.hash);
+
+        // The same hasher must give identical results after Reset()
+        uint256 hash;
+        reused.Reset().Write(in.data(), in.size()).Finalize(hash.begin());
+        BOOST_CHECK_EQUAL(hash.ToString(), v.hash);
+
+        // Streaming in odd-sized chunks must not change the honey lane
+        CHoneyCombHasher chunked;
+        for (size_t pos = 0; pos < in.size(); pos += 7) {
+            chunked.Write(in.data() + pos, std::min<size_t>(7, in.size() - pos));
+        }
+        chunked.Finalize(hash.begin());
+        BOOST_CHECK_EQUAL(hash.ToString(), v.hash);
+    }
+
+    // Non-zero 80 byte header-sized input, so that the head and tail of the honey lane differ
+    std::vector<unsigned char> header(80);
+    for (size_t i = 0; i < header.size(); i++) {
+        header[i] = (unsigned char)i;
+    }
+    BOOST_CHECK_EQUAL(HashHoneyComb(header.begin(), header.end()).ToString(), "5f9a4f8c74f9221c44f0a3836658d8c9363975cade8b30b34da6f8a57fc2f786");
+
+    // Short inputs have the missing honey bytes treated as zero
+    std::vector<unsigned char> in32(32, 0);
+    BOOST_CHECK_EQUAL(HashHoneyComb(in32.begin(), in32.end()).ToString(), "e956d4a52f49cc0035943090ba5b43b57c182c717c584ade5b467f47edf6f8d1");
+    BOOST_CHECK_EQUAL(HashHoneyComb(in32.begin(), in32.begin()).ToString(), "a238af03598042c81a158d64b14231c322a40a0dfc5f59233555b6f8b9e46e2e");
+}
+
+BOOST_AUTO_TEST_CASE(honeycomb_batch)
+{
+    std::vector<CBlockHeader> headers(2 * HONEYCOMB_BATCH_LANES + 3);
+    for (CBlockHeader& header : headers) {
+        header.nVersion = insecure_rand();
+        header.hashPrevBlock = GetRandHash();
+        header.hashMerkleRoot = GetRandHash();
+        header.nTime = insecure_rand();
+        header.nBits = insecure_rand();
+        header.nNonce = insecure_rand();
+    }
+
+    // Cover empty input, a partial group, exactly one group and several groups with a remainder
+    for (size_t n : {(size_t)0, (size_t)1, HONEYCOMB_BATCH_LANES - 1, HONEYCOMB_BATCH_LANES, headers.size()}) {
+        std::vector<uint256> hashes(n);
+        HashHoneyCombBatch(headers.data(), n, hashes.data());
+        for (size_t i = 0; i < n; i++) {
+            BOOST_CHECK_EQUAL(hashes[i].ToString(), headers[i].GetHash().ToString());
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+// Copyright (c) 2020 The BeeGroup developers are EternityGroup
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "test/test_beenode.h"
+
+#include "dbwrapper.h"
+#include "llmq/quorums_signing.h"
+#include "llmq/quorums_utils.h"
+#include "random.h"
+
+#include <boost/test/unit_test.hpp>
+
+using namespace llmq;
+
+static CRecoveredSig MakeRecoveredSig()
+{
+    CRecoveredSig recSig;
+    recSig.llmqType = Consensus::LLMQ_50_60;
+    recSig.quorumHash = GetRandHash();
+    recSig.id = GetRandHash();
+    recSig.msgHash = GetRandHash();
+    recSig.UpdateHash();
+    return recSig;
+}
+
+static bool HasAnyKeys(CRecoveredSigsDb& recSigsDb, const CRecoveredSig& recSig)
+{
+    auto llmqType = (Consensus::LLMQType)recSig.llmqType;
+    CRecoveredSig tmp;
+    return recSigsDb.HasRecoveredSig(llmqType, recSig.id, recSig.msgHash) ||
+           recSigsDb.HasRecoveredSigForId(llmqType, recSig.id) ||
+           recSigsDb.HasRecoveredSigForSession(CLLMQUtils::BuildSignHash(recSig)) ||
+           recSigsDb.HasRecoveredSigForHash(recSig.GetHash()) ||
+           recSigsDb.GetRecoveredSigById(llmqType, recSig.id, tmp);
+}
+
+BOOST_FIXTURE_TEST_SUITE(llmq_signing_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(recsigsdb_pending_writes)
+{
+    CDBWrapper db(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path(), 1 << 20, true);
+    auto recSig = MakeRecoveredSig();
+    auto llmqType = (Consensus::LLMQType)recSig.llmqType;
+    uint256 voteMsgHash = GetRandHash();
+
+    {
+        CRecoveredSigsDb recSigsDb(db);
+        recSigsDb.WriteRecoveredSig(recSig);
+        recSigsDb.WriteVoteForId(llmqType, recSig.id, voteMsgHash);
+
+        // nothing is in the DB yet, but everything must be readable already
+        BOOST_CHECK(!db.Exists(std::make_tuple(std::string("rs_h"), recSig.GetHash())));
+
+        CRecoveredSig ret;
+        BOOST_CHECK(recSigsDb.GetRecoveredSigByHash(recSig.GetHash(), ret));
+        BOOST_CHECK(ret.GetHash() == recSig.GetHash());
+        BOOST_CHECK(recSigsDb.HasRecoveredSig(llmqType, recSig.id, recSig.msgHash));
+
+        uint256 msgHash;
+        BOOST_CHECK(recSigsDb.HasVotedOnId(llmqType, recSig.id));
+        BOOST_CHECK(recSigsDb.GetVoteForId(llmqType, recSig.id, msgHash));
+        BOOST_CHECK(msgHash == voteMsgHash);
+
+        recSigsDb.CommitPendingWrites();
+        BOOST_CHECK(db.Exists(std::make_tuple(std::string("rs_h"), recSig.GetHash())));
+
+        recSigsDb.WriteRecoveredSig(MakeRecoveredSig());
+        // pending writes are committed on destruction
+    }
+
+    CRecoveredSigsDb recSigsDb(db);
+    CRecoveredSig ret;
+    BOOST_CHECK(recSigsDb.GetRecoveredSigById(llmqType, recSig.id, ret));
+    BOOST_CHECK(ret.GetHash() == recSig.GetHash());
+    BOOST_CHECK(recSigsDb.HasVotedOnId(llmqType, recSig.id));
+
+    recSigsDb.RemoveRecoveredSig(llmqType, recSig.id);
+    BOOST_CHECK(!HasAnyKeys(recSigsDb, recSig));
+}
+
+BOOST_AUTO_TEST_CASE(recsigsdb_cleanup)
+{
+    CDBWrapper db(boost::filesystem::temp_directory_path() / boost::filesystem::unique_path(), 1 << 20, true);
+    CRecoveredSigsDb recSigsDb(db);
+
+    std::vector<CRecoveredSig> recSigs;
+    for (int i = 0; i < 10; i++) {
+        recSigs.emplace_back(MakeRecoveredSig());
+        recSigsDb.WriteRecoveredSig(recSigs.back());
+    }
+    recSigsDb.CommitPendingWrites();
+
+    // simulate entries written by older versions, which only have a dummy value in the "rs_t" key
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    auto start = std::make_tuple(std::string("rs_t"), (uint32_t)0, (uint8_t)0, uint256());
+    pcursor->Seek(start);
+    size_t timeKeys = 0;
+    CDBBatch batch(db);
+    while (pcursor->Valid()) {
+        decltype(start) k;
+        if (!pcursor->GetKey(k) || std::get<0>(k) != "rs_t") {
+            break;
+        }
+        if (timeKeys++ % 2 == 0) {
+            batch.Write(k, (uint8_t)1);
+        }
+        pcursor->Next();
+    }
+    pcursor.reset();
+    db.WriteBatch(batch);
+    BOOST_CHECK_EQUAL(timeKeys, recSigs.size());
+
+    // nothing is old enough
+    recSigsDb.CleanupOldRecoveredSigs(60);
+    for (auto& recSig : recSigs) {
+        BOOST_CHECK(recSigsDb.HasRecoveredSigForHash(recSig.GetHash()));
+    }
+
+    // a negative age puts everything into the past
+    recSigsDb.CleanupOldRecoveredSigs(-60);
+    for (auto& recSig : recSigs) {
+        BOOST_CHECK(!HasAnyKeys(recSigsDb, recSig));
+    }
+
+    // no keys are left behind
+    pcursor.reset(db.NewIterator());
+    for (pcursor->SeekToFirst(); pcursor->Valid(); pcursor->Next()) {
+        std::tuple<std::string> k;
+        BOOST_CHECK(!pcursor->GetKey(k) || std::get<0>(k).compare(0, 3, "rs_") != 0);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
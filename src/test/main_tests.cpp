@@ -2,7 +2,10 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "chainparams.h"
 #include "net.h"
+#include "streams.h"
+#include "validation.h"
 
 #include "test/test_beenode.h"
 
@@ -27,4 +30,26 @@ BOOST_AUTO_TEST_CASE(test_combiner_all)
     Test.disconnect(&ReturnTrue);
     BOOST_CHECK(Test());
 }
+
+BOOST_FIXTURE_TEST_CASE(read_raw_block, TestChain100Setup)
+{
+    LOCK(cs_main);
+    for (const CBlockIndex* pindex = chainActive.Tip(); pindex; pindex = pindex->pprev) {
+        CBlock block;
+        std::vector<unsigned char> blockData;
+        BOOST_CHECK(ReadBlockFromDisk(block, pindex, Params().GetConsensus()));
+        BOOST_CHECK(ReadRawBlockFromDisk(blockData, pindex, Params().MessageStart()));
+
+        // the raw block must be usable as the payload of a BLOCK message
+        CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+        ss << block;
+        BOOST_CHECK(std::vector<unsigned char>(ss.begin(), ss.end()) == blockData);
+    }
+
+    // not pointing to the start of a block
+    CDiskBlockPos pos = chainActive.Tip()->GetBlockPos();
+    pos.nPos++;
+    std::vector<unsigned char> blockData;
+    BOOST_CHECK(!ReadRawBlockFromDisk(blockData, pos, Params().MessageStart()));
+}
 BOOST_AUTO_TEST_SUITE_END()
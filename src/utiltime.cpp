@@ -13,6 +13,8 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/thread.hpp>
 
+#include <time.h>
+
 static int64_t nMockTime = 0; //!< For unit testing
 
 int64_t GetTime()
@@ -63,6 +65,17 @@ int64_t GetLogTimeMicros()
     return GetTimeMicros();
 }
 
+int64_t GetThreadCPUTimeMicros()
+{
+#ifdef CLOCK_THREAD_CPUTIME_ID
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+    }
+#endif
+    return GetTimeMicros();
+}
+
 void MilliSleep(int64_t n)
 {
 
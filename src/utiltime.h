@@ -24,6 +24,7 @@ int64_t GetTimeMillis();
 int64_t GetTimeMicros();
 int64_t GetSystemTimeInSeconds(); // Like GetTime(), but not mockable
 int64_t GetLogTimeMicros();
+int64_t GetThreadCPUTimeMicros(); // CPU time consumed by the calling thread, falls back to GetTimeMicros()
 void SetMockTime(int64_t nMockTimeIn);
 bool IsMockTime();
 void MilliSleep(int64_t n);
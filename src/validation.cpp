@@ -1109,6 +1109,59 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus
     return true;
 }
 
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CDiskBlockPos& pos, const CMessageHeader::MessageStartChars& messageStart)
+{
+    block.clear();
+
+    // Open history file at the index header written by WriteBlockToDisk
+    CDiskBlockPos hpos = pos;
+    if (hpos.nPos < CMessageHeader::MESSAGE_START_SIZE + sizeof(unsigned int))
+        return error("ReadRawBlockFromDisk: invalid position %s", pos.ToString());
+    hpos.nPos -= CMessageHeader::MESSAGE_START_SIZE + sizeof(unsigned int);
+    CAutoFile filein(OpenBlockFile(hpos, true), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return error("ReadRawBlockFromDisk: OpenBlockFile failed for %s", pos.ToString());
+
+    try {
+        CMessageHeader::MessageStartChars blockStart;
+        unsigned int nSize;
+        filein >> FLATDATA(blockStart) >> nSize;
+
+        if (memcmp(blockStart, messageStart, CMessageHeader::MESSAGE_START_SIZE) != 0)
+            return error("%s: Block magic mismatch at %s", __func__, pos.ToString());
+        if (nSize > MAX_SIZE)
+            return error("%s: Block size %u too large at %s", __func__, nSize, pos.ToString());
+
+        block.resize(nSize);
+        filein.read((char*)block.data(), nSize);
+    }
+    catch (const std::exception& e) {
+        return error("%s: I/O error - %s at %s", __func__, e.what(), pos.ToString());
+    }
+
+    return true;
+}
+
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& block, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& messageStart)
+{
+    if (!ReadRawBlockFromDisk(block, pindex->GetBlockPos(), messageStart))
+        return false;
+
+    // Only the header is deserialized, which is enough to verify that we read the right block
+    CBlockHeader header;
+    try {
+        CDataStream ssHeader((const char*)block.data(), (const char*)block.data() + std::min(block.size(), (size_t)80), SER_NETWORK, PROTOCOL_VERSION);
+        ssHeader >> header;
+    }
+    catch (const std::exception& e) {
+        return error("%s: Deserialize error - %s at %s", __func__, e.what(), pindex->GetBlockPos().ToString());
+    }
+    if (header.GetHash() != pindex->GetBlockHash())
+        return error("ReadRawBlockFromDisk(std::vector<unsigned char>&, CBlockIndex*): GetHash() doesn't match index for %s at %s",
+                pindex->ToString(), pindex->GetBlockPos().ToString());
+    return true;
+}
+
 double ConvertBitsToDouble(unsigned int nBits)
 {
     int nShift = (nBits >> 24) & 0xff;
@@ -1781,6 +1834,49 @@ void ThreadScriptCheck() {
     scriptcheckqueue.Thread();
 }
 
+/**
+ * Closure computing the HoneyComb hashes of a run of consecutive headers and
+ * checking their proof of work. Does not need cs_main.
+ */
+class CHeaderPoWCheck
+{
+private:
+    const CBlockHeader* headers;
+    uint256* hashes;
+    size_t count;
+    const Consensus::Params* consensusParams;
+
+public:
+    CHeaderPoWCheck() : headers(NULL), hashes(NULL), count(0), consensusParams(NULL) {}
+    CHeaderPoWCheck(const CBlockHeader* headersIn, uint256* hashesIn, size_t countIn, const Consensus::Params& consensusParamsIn) :
+        headers(headersIn), hashes(hashesIn), count(countIn), consensusParams(&consensusParamsIn) {}
+
+    bool operator()()
+    {
+        HashHoneyCombBatch(headers, count, hashes);
+        for (size_t i = 0; i < count; i++) {
+            if (!CheckProofOfWork(hashes[i], headers[i].nBits, *consensusParams))
+                return false;
+        }
+        return true;
+    }
+
+    void swap(CHeaderPoWCheck& check)
+    {
+        std::swap(headers, check.headers);
+        std::swap(hashes, check.hashes);
+        std::swap(count, check.count);
+        std::swap(consensusParams, check.consensusParams);
+    }
+};
+
+static CCheckQueue<CHeaderPoWCheck> headercheckqueue(128);
+
+void ThreadHeaderCheck() {
+    RenameThread("beenode-hdrcheck");
+    headercheckqueue.Thread();
+}
+
 // Protected by cs_main
 VersionBitsCache versionbitscache;
 
@@ -3063,10 +3159,9 @@ bool ResetBlockFailureFlags(CBlockIndex *pindex) {
     return true;
 }
 
-CBlockIndex* AddToBlockIndex(const CBlockHeader& block, enum BlockStatus nStatus = BLOCK_VALID_TREE)
+CBlockIndex* AddToBlockIndex(const CBlockHeader& block, const uint256& hash, enum BlockStatus nStatus = BLOCK_VALID_TREE)
 {
     // Check for duplicate
-    uint256 hash = block.GetHash();
     BlockMap::iterator it = mapBlockIndex.find(hash);
     if (it != mapBlockIndex.end())
         return it->second;
@@ -3108,6 +3203,11 @@ CBlockIndex* AddToBlockIndex(const CBlockHeader& block, enum BlockStatus nStatus
     return pindexNew;
 }
 
+CBlockIndex* AddToBlockIndex(const CBlockHeader& block, enum BlockStatus nStatus = BLOCK_VALID_TREE)
+{
+    return AddToBlockIndex(block, block.GetHash(), nStatus);
+}
+
 /** Mark a block as having its data received and checked (up to BLOCK_VALID_TRANSACTIONS). */
 bool ReceivedBlockTransactions(const CBlock &block, CValidationState& state, CBlockIndex *pindexNew, const CDiskBlockPos& pos)
 {
@@ -3242,16 +3342,16 @@ bool FindUndoPos(CValidationState &state, int nFile, CDiskBlockPos &pos, unsigne
     return true;
 }
 
-bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW)
+bool CheckBlockHeader(const CBlockHeader& block, const uint256& hash, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW)
 {
     // Check proof of work matches claimed amount
-    if (fCheckPOW && !CheckProofOfWork(block.GetHash(), block.nBits, consensusParams))
+    if (fCheckPOW && !CheckProofOfWork(hash, block.nBits, consensusParams))
         return state.DoS(50, false, REJECT_INVALID, "high-hash", false, "proof of work failed");
 
     // Check DevNet
     if (!consensusParams.hashDevnetGenesisBlock.IsNull() &&
             block.hashPrevBlock == consensusParams.hashGenesisBlock &&
-            block.GetHash() != consensusParams.hashDevnetGenesisBlock) {
+            hash != consensusParams.hashDevnetGenesisBlock) {
         return state.DoS(100, error("CheckBlockHeader(): wrong devnet genesis"),
                          REJECT_INVALID, "devnet-genesis");
     }
@@ -3259,6 +3359,11 @@ bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const
     return true;
 }
 
+bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW)
+{
+    return CheckBlockHeader(block, block.GetHash(), state, consensusParams, fCheckPOW);
+}
+
 bool CheckBlock(const CBlock& block, CValidationState& state, const Consensus::Params& consensusParams, bool fCheckPOW, bool fCheckMerkleRoot)
 {
     // These are checks that are independent of context.
@@ -3431,11 +3536,14 @@ bool ContextualCheckBlock(const CBlock& block, CValidationState& state, const Co
     return true;
 }
 
-static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex)
+/**
+ * Accept a header with an already computed hash into the block index.
+ * fCheckPOW may only be false if the proof of work of this hash was already checked.
+ */
+static bool AcceptBlockHeader(const CBlockHeader& block, const uint256& hash, CValidationState& state, const CChainParams& chainparams, CBlockIndex** ppindex, bool fCheckPOW = true)
 {
     AssertLockHeld(cs_main);
     // Check for duplicate
-    uint256 hash = block.GetHash();
     BlockMap::iterator miSelf = mapBlockIndex.find(hash);
     CBlockIndex *pindex = NULL;
 
@@ -3452,7 +3560,7 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
             return true;
         }
 
-        if (!CheckBlockHeader(block, state, chainparams.GetConsensus()))
+        if (!CheckBlockHeader(block, hash, state, chainparams.GetConsensus(), fCheckPOW))
             return error("%s: Consensus::CheckBlockHeader: %s, %s", __func__, hash.ToString(), FormatStateMessage(state));
 
         // Get prev block index
@@ -3478,13 +3586,13 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
 
         if (llmq::chainLocksHandler->HasConflictingChainLock(pindexPrev->nHeight + 1, hash)) {
             if (pindex == NULL) {
-                AddToBlockIndex(block, BLOCK_CONFLICT_CHAINLOCK);
+                AddToBlockIndex(block, hash, BLOCK_CONFLICT_CHAINLOCK);
             }
             return state.DoS(10, error("%s: header %s conflicts with chainlock", __func__, hash.ToString()), REJECT_INVALID, "bad-chainlock");
         }
     }
     if (pindex == NULL)
-        pindex = AddToBlockIndex(block);
+        pindex = AddToBlockIndex(block, hash);
 
     if (ppindex)
         *ppindex = pindex;
@@ -3497,14 +3605,48 @@ static bool AcceptBlockHeader(const CBlockHeader& block, CValidationState& state
     return true;
 }
 
+/**
+ * Hash all headers and check their proof of work on the header check threads.
+ * Called without cs_main. Returns false if any header failed the check, in which
+ * case hashes may be incomplete and must not be used.
+ */
+static bool PreCheckBlockHeaders(const std::vector<CBlockHeader>& headers, std::vector<uint256>& hashes, const Consensus::Params& consensusParams)
+{
+    hashes.resize(headers.size());
+
+    std::vector<CHeaderPoWCheck> vChecks;
+    vChecks.reserve(headers.size() / HONEYCOMB_BATCH_LANES + 1);
+    for (size_t pos = 0; pos < headers.size(); pos += HONEYCOMB_BATCH_LANES) {
+        size_t count = std::min(HONEYCOMB_BATCH_LANES, headers.size() - pos);
+        vChecks.emplace_back(&headers[pos], &hashes[pos], count, consensusParams);
+    }
+
+    if (!nScriptCheckThreads || vChecks.size() < 2) {
+        for (CHeaderPoWCheck& check : vChecks) {
+            if (!check())
+                return false;
+        }
+        return true;
+    }
+
+    CCheckQueueControl<CHeaderPoWCheck> control(&headercheckqueue);
+    control.Add(vChecks);
+    return control.Wait();
+}
+
 // Exposed wrapper for AcceptBlockHeader
 bool ProcessNewBlockHeaders(const std::vector<CBlockHeader>& headers, CValidationState& state, const CChainParams& chainparams, const CBlockIndex** ppindex)
 {
+    // Do the expensive part (hashing and PoW) in parallel and outside of cs_main. If any header
+    // fails, fall back to checking one by one so that the offending header is reported as before.
+    std::vector<uint256> hashes;
+    bool fPoWChecked = PreCheckBlockHeaders(headers, hashes, chainparams.GetConsensus());
     {
         LOCK(cs_main);
-        for (const CBlockHeader& header : headers) {
+        for (size_t i = 0; i < headers.size(); i++) {
+            const CBlockHeader& header = headers[i];
             CBlockIndex *pindex = NULL; // Use a temp pindex instead of ppindex to avoid a const_cast
-            if (!AcceptBlockHeader(header, state, chainparams, &pindex)) {
+            if (!AcceptBlockHeader(header, fPoWChecked ? hashes[i] : header.GetHash(), state, chainparams, &pindex, !fPoWChecked)) {
                 return false;
             }
             if (ppindex) {
@@ -3527,7 +3669,7 @@ static bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, CValidation
     CBlockIndex *pindexDummy = NULL;
     CBlockIndex *&pindex = ppindex ? *ppindex : pindexDummy;
 
-    if (!AcceptBlockHeader(block, state, chainparams, &pindex))
+    if (!AcceptBlockHeader(block, block.GetHash(), state, chainparams, &pindex))
         return false;
 
     // Try to process all requested blocks that we don't have, but only